@@ -117,6 +117,12 @@ def configs_optimal_extended():
         "pdb": [
             "--search",
             "astar(pdb())"],
+        "bjolp_optimal_combinatorial": [
+            "--evaluator",
+            "lmc=landmark_cost_partitioning(lm_merged([lm_rhw(),lm_hm(m=1)]),"
+            "optimal=true,optimal_solver=combinatorial)",
+            "--search",
+            "astar(lmc,lazy_evaluator=lmc)"],
     }
 
 
@@ -168,6 +174,11 @@ def configs_optimal_lp(lp_solver="cplex"):
     return {
         "divpot": ["--search", f"astar(diverse_potentials(lpsolver={lp_solver}))"],
         "seq+lmcut": ["--search", f"astar(operatorcounting([state_equation_constraints(), lmcut_constraints()], lpsolver={lp_solver}))"],
+        "bjolp_optimal": [
+            "--evaluator",
+            f"lmc=landmark_cost_partitioning(lm_merged([lm_rhw(),lm_hm(m=1)]),optimal=true,lpsolver={lp_solver})",
+            "--search",
+            "astar(lmc,lazy_evaluator=lmc)"],
     }
 
 
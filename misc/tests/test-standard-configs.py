@@ -70,5 +70,32 @@ def test_configs_soplex(config, debug):
     run_plan_script(SAS_FILE, config, debug)
 
 
+def get_search_statistics(config):
+    output = subprocess.check_output(
+        [sys.executable, FAST_DOWNWARD, "--plan-file", PLAN_FILE, SAS_FILE] + config,
+        cwd=REPO, text=True)
+    # Strip time and memory and the heuristic descriptions.
+    return [line.split("]", 1)[1].rsplit(":", 1)[-1]
+            for line in output.splitlines()
+            if "Expanded" in line or "heuristic value" in line]
+
+
+@pytest.mark.parametrize("task", ["gripper/prob01.pddl", "miconic/s1-0.pddl"])
+def test_optimal_landmark_cost_partitioning_solvers_agree(task):
+    """The combinatorial solver must compute the same heuristic values as
+    the LP, so A* expands the same states in the same order."""
+    translate(os.path.join(BENCHMARKS_DIR, task))
+    statistics = []
+    for solver in ["optimal_solver=lp,lpsolver=builtin", "optimal_solver=combinatorial"]:
+        statistics.append(get_search_statistics([
+            "--evaluator",
+            "lmc=landmark_cost_partitioning(lm_merged([lm_rhw(),lm_hm(m=1)]),"
+            f"optimal=true,{solver})",
+            "--search",
+            "astar(lmc,lazy_evaluator=lmc)"]))
+    translate(TASK)
+    assert statistics[0] and statistics[0] == statistics[1]
+
+
 def teardown_module(module):
     cleanup()
@@ -73,6 +73,7 @@ fast_downward_plugin(
         search_statistics
         state_id
         state_registry
+        state_storage
         task_id
         task_proxy
 
@@ -122,6 +123,8 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/memory_mapped_file
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
@@ -456,6 +459,14 @@ fast_downward_plugin(
     DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
 )
 
+fast_downward_plugin(
+    NAME EXTERNAL_SEARCH
+    HELP "External A* search"
+    SOURCES
+        search_algorithms/external_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ITERATED_SEARCH
     HELP "Iterated search"
@@ -463,6 +474,13 @@ fast_downward_plugin(
         search_algorithms/iterated_search
 )
 
+fast_downward_plugin(
+    NAME PORTFOLIO_SEARCH
+    HELP "Portfolio search"
+    SOURCES
+        search_algorithms/portfolio_search
+)
+
 fast_downward_plugin(
     NAME LAZY_SEARCH
     HELP "Lazy search"
@@ -476,6 +494,7 @@ fast_downward_plugin(
     NAME LP_SOLVER
     HELP "Interface to an LP solver"
     SOURCES
+        lp/builtin_solver_interface
         lp/cplex_solver_interface
         lp/lp_internals
         lp/lp_solver
@@ -653,6 +672,8 @@ fast_downward_plugin(
         cartesian_abstractions/cegar
         cartesian_abstractions/cost_saturation
         cartesian_abstractions/refinement_hierarchy
+        cartesian_abstractions/shared_refinement_limits
+        cartesian_abstractions/slice_arena
         cartesian_abstractions/split_selector
         cartesian_abstractions/subtask_generators
         cartesian_abstractions/transition
@@ -667,6 +688,7 @@ fast_downward_plugin(
     NAME MAS_HEURISTIC
     HELP "The Merge-and-Shrink heuristic"
     SOURCES
+        merge_and_shrink/compact_representation
         merge_and_shrink/distances
         merge_and_shrink/factored_transition_system
         merge_and_shrink/fts_factory
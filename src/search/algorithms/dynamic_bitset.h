@@ -17,7 +17,7 @@ class DynamicBitset {
         "Block type must be unsigned");
 
     std::vector<Block> blocks;
-    const std::size_t num_bits;
+    std::size_t num_bits;
 
     static const Block zeros;
     static const Block ones;
@@ -123,6 +123,24 @@ public:
         }
         return true;
     }
+
+    DynamicBitset &operator|=(const DynamicBitset &other) {
+        assert(size() == other.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] |= other.blocks[i];
+        }
+        return *this;
+    }
+
+    /* Access whole blocks for word-wise operations. Bits beyond size()
+       in the last block are always unset. */
+    std::size_t get_num_blocks() const {
+        return blocks.size();
+    }
+
+    Block get_block(std::size_t block_index) const {
+        return blocks[block_index];
+    }
 };
 
 template<typename Block>
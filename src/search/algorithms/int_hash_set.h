@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -25,26 +27,16 @@ namespace int_hash_set {
   Usage:
 
   IntHashSet<MyHasher, MyEqualityTester> s;
-  pair<int, bool> result1 = s.insert(3);
+  pair<KeyType, bool> result1 = s.insert(3);
   assert(result1 == make_pair(3, true));
-  pair<int, bool> result2 = s.insert(3);
+  pair<KeyType, bool> result2 = s.insert(3);
   assert(result2 == make_pair(3, false));
 
   Limitations:
 
-  We use 32-bit (signed and unsigned) integers instead of larger data
-  types for keys and hashes to save memory.
-
-  Consequently, the range of valid keys is [0, 2^31 - 1]. This range
-  could be extended to [0, 2^32 - 2] without using more memory by
-  using unsigned integers for the keys and a different designated
-  value for empty buckets (currently we use -1 for this).
-
-  The maximum capacity (i.e., number of buckets) is 2^30 because we
-  use a signed integer to store it, we grow the hash set by doubling
-  its capacity, and the next larger power of 2 (2^31) is too big for
-  an int. The maximum capacity could be increased by storing the
-  number of buckets in a larger data type.
+  We use 32-bit unsigned integers instead of larger data types for keys
+  and hashes to save memory. The range of valid keys is [0, 2^32 - 2]
+  since we use 2^32 - 1 to mark empty buckets.
 
   Note on hash functions:
 
@@ -58,34 +50,41 @@ namespace int_hash_set {
 
   Implementation:
 
-  All data and hashes are stored in a single vector, using open
-  addressing. We use ideas from hopscotch hashing
-  (https://en.wikipedia.org/wiki/Hopscotch_hashing) to ensure that
-  each key is at most "max_distance" buckets away from its ideal
+  The keys are distributed over NUM_SUBTABLES subtables by the highest
+  bits of their hashes. Each subtable stores its keys and hashes in a
+  single vector, using open addressing. We use ideas from hopscotch
+  hashing (https://en.wikipedia.org/wiki/Hopscotch_hashing) to ensure
+  that each key is at most "max_distance" buckets away from its ideal
   bucket. This ensures constant lookup times since we always need to
   check at most "max_distance" buckets. Since all buckets we need to
   check for a given key are aligned in memory, the lookup has good
   cache locality.
 
+  Subtables grow independently by doubling their capacity. Compared to
+  growing one table for all keys, this spreads the rehashing over many
+  insertions, each moving only a small fraction of the keys, and the
+  temporary memory overhead while rehashing is only a small fraction
+  of the size of the hash set, instead of twice its size. The number of
+  buckets is only limited by the 32-bit hashes: with more than 2^32
+  buckets in total, not all buckets can be ideal buckets.
 */
 
-using KeyType = int;
-using HashType = unsigned int;
-
-static_assert(sizeof(KeyType) == 4, "KeyType does not use 4 bytes");
-static_assert(sizeof(HashType) == 4, "HashType does not use 4 bytes");
+using KeyType = uint32_t;
+using HashType = uint32_t;
 
 template<typename Hasher, typename Equal>
 class IntHashSet {
     // Max distance from the ideal bucket to the actual bucket for each key.
     static const int MAX_DISTANCE = 32;
-    static const unsigned int MAX_BUCKETS = std::numeric_limits<unsigned int>::max();
+    static const int NUM_SUBTABLE_BITS = 8;
+    static const int NUM_SUBTABLES = 1 << NUM_SUBTABLE_BITS;
+    static const std::size_t MAX_BUCKETS_PER_SUBTABLE = std::size_t(1) << 32;
 
     struct Bucket {
         KeyType key;
         HashType hash;
 
-        static const KeyType empty_bucket_key = -1;
+        static const KeyType empty_bucket_key = std::numeric_limits<KeyType>::max();
 
         Bucket()
             : key(empty_bucket_key),
@@ -102,38 +101,86 @@ class IntHashSet {
         }
     };
 
+    struct Subtable {
+        std::vector<Bucket> buckets;
+        std::size_t num_entries;
+
+        Subtable()
+            : buckets(1),
+              num_entries(0) {
+        }
+
+        std::size_t capacity() const {
+            return buckets.size();
+        }
+
+        std::size_t get_bucket(std::size_t hash) const {
+            assert(!buckets.empty());
+            std::size_t num_buckets = buckets.size();
+            // Verify that the number of buckets is a power of 2.
+            assert((num_buckets & (num_buckets - 1)) == 0);
+            /* We want to return hash % num_buckets. The following line does
+               this because we know that num_buckets is a power of 2. */
+            return hash & (num_buckets - 1);
+        }
+
+        /*
+          Return distance from index1 to index2, only moving right and
+          wrapping from the last to the first bucket.
+        */
+        std::size_t get_distance(std::size_t index1, std::size_t index2) const {
+            assert(index1 < capacity());
+            assert(index2 < capacity());
+            if (index2 >= index1) {
+                return index2 - index1;
+            } else {
+                return capacity() + index2 - index1;
+            }
+        }
+
+        std::size_t find_next_free_bucket_index(std::size_t index) const {
+            assert(num_entries < capacity());
+            assert(index < capacity());
+            while (buckets[index].full()) {
+                index = get_bucket(index + 1);
+            }
+            return index;
+        }
+    };
+
     Hasher hasher;
     Equal equal;
-    std::vector<Bucket> buckets;
-    int num_entries;
+    std::vector<Subtable> subtables;
+    int64_t num_entries;
     int num_resizes;
 
-    int capacity() const {
-        return buckets.size();
+    static int get_subtable_index(HashType hash) {
+        return hash >> (std::numeric_limits<HashType>::digits - NUM_SUBTABLE_BITS);
     }
 
-    void rehash(int new_capacity) {
+    void rehash(Subtable &subtable, std::size_t new_capacity) {
         assert(new_capacity >= 1);
-        int num_entries_before = num_entries;
-        std::vector<Bucket> old_buckets = std::move(buckets);
-        assert(buckets.empty());
-        num_entries = 0;
-        buckets.resize(new_capacity);
+        std::size_t num_entries_before = subtable.num_entries;
+        std::vector<Bucket> old_buckets = std::move(subtable.buckets);
+        assert(subtable.buckets.empty());
+        num_entries -= subtable.num_entries;
+        subtable.num_entries = 0;
+        subtable.buckets.resize(new_capacity);
         for (const Bucket &bucket : old_buckets) {
             if (bucket.full()) {
-                insert(bucket.key, bucket.hash);
+                insert(subtable, bucket.key, bucket.hash);
             }
         }
         utils::unused_variable(num_entries_before);
-        assert(num_entries == num_entries_before);
+        assert(subtable.num_entries == num_entries_before);
         ++num_resizes;
     }
 
-    void enlarge() {
-        unsigned int num_buckets = buckets.size();
+    void enlarge(Subtable &subtable) {
+        std::size_t num_buckets = subtable.capacity();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
-        if (num_buckets > MAX_BUCKETS / 2) {
+        if (num_buckets >= MAX_BUCKETS_PER_SUBTABLE) {
             std::cerr << "IntHashSet surpassed maximum capacity. This means"
                 " you either use IntHashSet for high-memory"
                 " applications for which it was not designed, or there"
@@ -142,48 +189,16 @@ class IntHashSet {
                       << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
-        rehash(num_buckets * 2);
-    }
-
-    int get_bucket(HashType hash) const {
-        assert(!buckets.empty());
-        unsigned int num_buckets = buckets.size();
-        // Verify that the number of buckets is a power of 2.
-        assert((num_buckets & (num_buckets - 1)) == 0);
-        /* We want to return hash % num_buckets. The following line does this
-           because we know that num_buckets is a power of 2. */
-        return hash & (num_buckets - 1);
-    }
-
-    /*
-      Return distance from index1 to index2, only moving right and wrapping
-      from the last to the first bucket.
-    */
-    int get_distance(int index1, int index2) const {
-        assert(utils::in_bounds(index1, buckets));
-        assert(utils::in_bounds(index2, buckets));
-        if (index2 >= index1) {
-            return index2 - index1;
-        } else {
-            return capacity() + index2 - index1;
-        }
+        rehash(subtable, num_buckets * 2);
     }
 
-    int find_next_free_bucket_index(int index) const {
-        assert(num_entries < capacity());
-        assert(utils::in_bounds(index, buckets));
-        while (buckets[index].full()) {
-            index = get_bucket(index + 1);
-        }
-        return index;
-    }
-
-    KeyType find_equal_key(KeyType key, HashType hash) const {
+    KeyType find_equal_key(
+        const Subtable &subtable, KeyType key, HashType hash) const {
         assert(hasher(key) == hash);
-        int ideal_index = get_bucket(hash);
+        std::size_t ideal_index = subtable.get_bucket(hash);
         for (int i = 0; i < MAX_DISTANCE; ++i) {
-            int index = get_bucket(ideal_index + i);
-            const Bucket &bucket = buckets[index];
+            std::size_t index = subtable.get_bucket(ideal_index + i);
+            const Bucket &bucket = subtable.buckets[index];
             if (bucket.full() && bucket.hash == hash && equal(bucket.key, key)) {
                 return bucket.key;
             }
@@ -193,39 +208,39 @@ class IntHashSet {
 
     /*
       Private method that inserts a key and its corresponding hash into the
-      hash set.
+      given subtable.
 
       The method ensures that each key is at most "max_distance" buckets away
       from its ideal bucket by moving the closest free bucket towards the ideal
-      bucket. If this can't be achieved, we resize the vector, reinsert the old
-      keys and try inserting the new key again.
+      bucket. If this can't be achieved, we resize the subtable, reinsert its
+      old keys and try inserting the new key again.
 
       For the return type, see the public insert() method.
 
       Note that the private insert() may call enlarge() and therefore rehash(),
       which itself calls the private insert() again.
     */
-    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+    std::pair<KeyType, bool> insert(Subtable &subtable, KeyType key, HashType hash) {
         assert(hasher(key) == hash);
 
         /* If the hash set already contains the key, return the key and a
            Boolean indicating that no new key has been inserted. */
-        KeyType equal_key = find_equal_key(key, hash);
+        KeyType equal_key = find_equal_key(subtable, key, hash);
         if (equal_key != Bucket::empty_bucket_key) {
             return std::make_pair(equal_key, false);
         }
 
-        assert(num_entries <= capacity());
-        if (num_entries == capacity()) {
-            enlarge();
+        assert(subtable.num_entries <= subtable.capacity());
+        if (subtable.num_entries == subtable.capacity()) {
+            enlarge(subtable);
         }
-        assert(num_entries < capacity());
+        assert(subtable.num_entries < subtable.capacity());
 
         // Compute ideal bucket.
-        int ideal_index = get_bucket(hash);
+        std::size_t ideal_index = subtable.get_bucket(hash);
 
         // Find first free bucket left of the ideal bucket.
-        int free_index = find_next_free_bucket_index(ideal_index);
+        std::size_t free_index = subtable.find_next_free_bucket_index(ideal_index);
 
         /*
           While the free bucket is too far from the ideal bucket, move the free
@@ -234,18 +249,19 @@ class IntHashSet {
           the swap doesn't move the full bucket too far from its ideal
           position.
         */
-        while (get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
+        std::vector<Bucket> &buckets = subtable.buckets;
+        while (subtable.get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
             bool swapped = false;
-            int num_buckets = capacity();
-            int max_offset = std::min(MAX_DISTANCE, num_buckets) - 1;
-            for (int offset = max_offset; offset >= 1; --offset) {
+            std::size_t num_buckets = subtable.capacity();
+            std::size_t max_offset =
+                std::min<std::size_t>(MAX_DISTANCE, num_buckets) - 1;
+            for (std::size_t offset = max_offset; offset >= 1; --offset) {
                 assert(offset < num_buckets);
-                int candidate_index = free_index + num_buckets - offset;
-                assert(candidate_index >= 0);
-                candidate_index = get_bucket(candidate_index);
+                std::size_t candidate_index =
+                    subtable.get_bucket(free_index + num_buckets - offset);
                 HashType candidate_hash = buckets[candidate_index].hash;
-                int candidate_ideal_index = get_bucket(candidate_hash);
-                if (get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
+                std::size_t candidate_ideal_index = subtable.get_bucket(candidate_hash);
+                if (subtable.get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
                     // Candidate can be swapped.
                     std::swap(buckets[candidate_index], buckets[free_index]);
                     free_index = candidate_index;
@@ -256,27 +272,36 @@ class IntHashSet {
             if (!swapped) {
                 /* Free bucket could not be moved close enough to ideal bucket.
                    -> Enlarge and try inserting again. */
-                enlarge();
-                return insert(key, hash);
+                enlarge(subtable);
+                return insert(subtable, key, hash);
             }
         }
-        assert(utils::in_bounds(free_index, buckets));
+        assert(free_index < buckets.size());
         assert(!buckets[free_index].full());
         buckets[free_index] = Bucket(key, hash);
+        ++subtable.num_entries;
         ++num_entries;
         return std::make_pair(key, true);
     }
 
+    std::size_t capacity() const {
+        std::size_t num_buckets = 0;
+        for (const Subtable &subtable : subtables) {
+            num_buckets += subtable.capacity();
+        }
+        return num_buckets;
+    }
+
 public:
     IntHashSet(const Hasher &hasher, const Equal &equal)
         : hasher(hasher),
           equal(equal),
-          buckets(1),
+          subtables(NUM_SUBTABLES),
           num_entries(0),
           num_resizes(0) {
     }
 
-    int size() const {
+    int64_t size() const {
         return num_entries;
     }
 
@@ -288,30 +313,32 @@ public:
       indicating whether a new key was inserted into the hash set.
     */
     std::pair<KeyType, bool> insert(KeyType key) {
-        assert(key >= 0);
-        return insert(key, hasher(key));
+        assert(key != Bucket::empty_bucket_key);
+        HashType hash = hasher(key);
+        return insert(subtables[get_subtable_index(hash)], key, hash);
     }
 
     void dump(utils::LogProxy &log) const {
-        int num_buckets = capacity();
         log << "[";
-        for (int i = 0; i < num_buckets; ++i) {
-            const Bucket &bucket = buckets[i];
-            if (bucket.full()) {
-                log << bucket.key;
-            } else {
-                log << "_";
-            }
-            if (i < num_buckets - 1) {
-                log << ", ";
+        for (int i = 0; i < NUM_SUBTABLES; ++i) {
+            const std::vector<Bucket> &buckets = subtables[i].buckets;
+            for (std::size_t j = 0; j < buckets.size(); ++j) {
+                const Bucket &bucket = buckets[j];
+                if (bucket.full()) {
+                    log << bucket.key;
+                } else {
+                    log << "_";
+                }
+                if (i < NUM_SUBTABLES - 1 || j < buckets.size() - 1) {
+                    log << ", ";
+                }
             }
         }
         log << "]" << std::endl;
     }
 
     void print_statistics(utils::LogProxy &log) const {
-        assert(!buckets.empty());
-        int num_buckets = capacity();
+        std::size_t num_buckets = capacity();
         assert(num_buckets != 0);
         log << "Int hash set load factor: " << num_entries << "/"
             << num_buckets << " = "
@@ -325,7 +352,13 @@ template<typename Hasher, typename Equal>
 const int IntHashSet<Hasher, Equal>::MAX_DISTANCE;
 
 template<typename Hasher, typename Equal>
-const unsigned int IntHashSet<Hasher, Equal>::MAX_BUCKETS;
+const int IntHashSet<Hasher, Equal>::NUM_SUBTABLE_BITS;
+
+template<typename Hasher, typename Equal>
+const int IntHashSet<Hasher, Equal>::NUM_SUBTABLES;
+
+template<typename Hasher, typename Equal>
+const std::size_t IntHashSet<Hasher, Equal>::MAX_BUCKETS_PER_SUBTABLE;
 }
 
 #endif
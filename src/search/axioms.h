@@ -5,6 +5,7 @@
 #include "task_proxy.h"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class AxiomEvaluator {
@@ -53,6 +54,12 @@ class AxiomEvaluator {
       to reduce reallocation effort. See issue420.
     */
     std::vector<const AxiomLiteral *> queue;
+    /*
+      The evaluator is shared by all state registries of the task and the
+      data above is modified during evaluation, so we only let one thread
+      evaluate at a time (see portfolio search).
+    */
+    std::mutex evaluation_mutex;
 
     template<typename Values, typename Accessor>
     void evaluate_aux(Values &values, const Accessor &accessor);
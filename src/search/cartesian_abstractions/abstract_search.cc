@@ -74,7 +74,7 @@ void AbstractSearch::update_goal_distances(const Solution &solution) {
 }
 
 unique_ptr<Solution> AbstractSearch::find_solution(
-    const vector<Transitions> &transitions,
+    const TransitionArena &transitions,
     int init_id,
     const Goals &goal_ids) {
     reset(transitions.size());
@@ -94,7 +94,7 @@ unique_ptr<Solution> AbstractSearch::find_solution(
 }
 
 int AbstractSearch::astar_search(
-    const vector<Transitions> &transitions, const Goals &goals) {
+    const TransitionArena &transitions, const Goals &goals) {
     while (!open_queue.empty()) {
         pair<int, int> top_pair = open_queue.pop();
         int old_f = top_pair.first;
@@ -155,7 +155,7 @@ void AbstractSearch::copy_h_value_to_children(int v, int v1, int v2) {
 
 
 vector<int> compute_distances(
-    const vector<Transitions> &transitions,
+    const TransitionArena &transitions,
     const vector<int> &costs,
     const unordered_set<int> &start_ids) {
     vector<int> distances(transitions.size(), INF);
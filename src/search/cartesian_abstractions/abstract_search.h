@@ -1,6 +1,7 @@
 #ifndef CARTESIAN_ABSTRACTIONS_ABSTRACT_SEARCH_H
 #define CARTESIAN_ABSTRACTIONS_ABSTRACT_SEARCH_H
 
+#include "slice_arena.h"
 #include "transition.h"
 #include "types.h"
 
@@ -73,14 +74,14 @@ public:
     std::unique_ptr<Solution> extract_solution(int init_id, int goal_id) const;
     void update_goal_distances(const Solution &solution);
     int astar_search(
-        const std::vector<Transitions> &transitions,
+        const TransitionArena &transitions,
         const Goals &goals);
 
 public:
     explicit AbstractSearch(const std::vector<int> &operator_costs);
 
     std::unique_ptr<Solution> find_solution(
-        const std::vector<Transitions> &transitions,
+        const TransitionArena &transitions,
         int init_id,
         const Goals &goal_ids);
     int get_h_value(int state_id) const;
@@ -88,7 +89,7 @@ public:
 };
 
 std::vector<int> compute_distances(
-    const std::vector<Transitions> &transitions,
+    const TransitionArena &transitions,
     const std::vector<int> &costs,
     const std::unordered_set<int> &start_ids);
 }
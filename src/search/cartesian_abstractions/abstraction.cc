@@ -63,6 +63,10 @@ void Abstraction::mark_all_states_as_goals() {
     }
 }
 
+void Abstraction::compact_transition_system() {
+    transition_system->compact();
+}
+
 void Abstraction::initialize_trivial_abstraction(const vector<int> &domain_sizes) {
     unique_ptr<AbstractState> init_state =
         AbstractState::get_trivial_abstract_state(domain_sizes);
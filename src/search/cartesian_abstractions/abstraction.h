@@ -61,6 +61,9 @@ public:
     /* Needed for CEGAR::separate_facts_unreachable_before_goal(). */
     void mark_all_states_as_goals();
 
+    // Store transitions compactly once refinement has finished.
+    void compact_transition_system();
+
     // Split state into two child states.
     std::pair<int, int> refine(
         const AbstractState &state, int var, const std::vector<int> &wanted);
@@ -32,6 +32,7 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<double>("max_time"),
         opts.get<bool>("use_general_costs"),
         opts.get<PickSplit>("pick"),
+        opts.get<int>("threads"),
         *rng,
         log);
     return cost_saturation.generate_heuristic_functions(
@@ -125,6 +126,19 @@ public:
             "use_general_costs",
             "allow negative costs in cost partitioning",
             "true");
+        add_option<int>(
+            "threads",
+            "number of threads for building abstractions. For threads=1, "
+            "each abstraction is built for the operator costs left over by "
+            "the previous abstractions. For more threads, all abstractions "
+            "are built concurrently for the original operator costs and "
+            "saturated cost partitioning is applied afterwards. Then the "
+            "limits on states, transitions and time are shared by all "
+            "threads and max_time is measured in CPU time summed over all "
+            "threads. Which abstractions reach the shared limits first "
+            "depends on the scheduling of the threads.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         Heuristic::add_options_to_feature(*this);
         utils::add_rng_options(*this);
 
@@ -3,6 +3,7 @@
 #include "abstraction.h"
 #include "abstract_state.h"
 #include "cartesian_set.h"
+#include "shared_refinement_limits.h"
 #include "transition_system.h"
 #include "utils.h"
 
@@ -85,7 +86,8 @@ CEGAR::CEGAR(
     double max_time,
     PickSplit pick,
     utils::RandomNumberGenerator &rng,
-    utils::LogProxy &log)
+    utils::LogProxy &log,
+    SharedRefinementLimits *shared_limits)
     : task_proxy(*task),
       domain_sizes(get_domain_sizes(task_proxy)),
       max_states(max_states),
@@ -94,6 +96,9 @@ CEGAR::CEGAR(
       abstraction(utils::make_unique_ptr<Abstraction>(task, log)),
       abstract_search(task_properties::get_operator_costs(task_proxy)),
       timer(max_time),
+      shared_limits(shared_limits),
+      num_reported_states(0),
+      num_reported_non_looping_transitions(0),
       log(log) {
     assert(max_states >= 1);
     if (log.is_at_least_normal()) {
@@ -104,6 +109,7 @@ CEGAR::CEGAR(
     }
 
     refinement_loop(rng);
+    abstraction->compact_transition_system();
     if (log.is_at_least_normal()) {
         log << "Done building abstraction." << endl;
         log << "Time for building abstraction: " << timer.get_elapsed_time() << endl;
@@ -142,7 +148,21 @@ void CEGAR::separate_facts_unreachable_before_goal() {
     abstraction->mark_all_states_as_goals();
 }
 
-bool CEGAR::may_keep_refining() const {
+void CEGAR::report_to_shared_limits() {
+    int num_states = abstraction->get_num_states();
+    int num_non_looping_transitions =
+        abstraction->get_transition_system().get_num_non_loops();
+    shared_limits->add(
+        num_states - num_reported_states,
+        num_non_looping_transitions - num_reported_non_looping_transitions);
+    num_reported_states = num_states;
+    num_reported_non_looping_transitions = num_non_looping_transitions;
+}
+
+bool CEGAR::may_keep_refining() {
+    if (shared_limits) {
+        report_to_shared_limits();
+    }
     if (abstraction->get_num_states() >= max_states) {
         if (log.is_at_least_normal()) {
             log << "Reached maximum number of states." << endl;
@@ -153,6 +173,11 @@ bool CEGAR::may_keep_refining() const {
             log << "Reached maximum number of transitions." << endl;
         }
         return false;
+    } else if (shared_limits && shared_limits->is_exhausted()) {
+        if (log.is_at_least_normal()) {
+            log << "Reached shared limit of states or transitions." << endl;
+        }
+        return false;
     } else if (timer.is_expired()) {
         if (log.is_at_least_normal()) {
             log << "Reached time limit." << endl;
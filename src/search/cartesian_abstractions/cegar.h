@@ -18,6 +18,7 @@ class LogProxy;
 namespace cartesian_abstractions {
 class Abstraction;
 struct Flaw;
+class SharedRefinementLimits;
 
 /*
   Iteratively refine a Cartesian abstraction with counterexample-guided
@@ -40,9 +41,16 @@ class CEGAR {
     // Limit the time for building the abstraction.
     utils::CountdownTimer timer;
 
+    /* Limits shared with concurrently running CEGAR instances (may be
+       nullptr) and the abstraction sizes already reported to them. */
+    SharedRefinementLimits *shared_limits;
+    int num_reported_states;
+    int num_reported_non_looping_transitions;
+
     utils::LogProxy &log;
 
-    bool may_keep_refining() const;
+    void report_to_shared_limits();
+    bool may_keep_refining();
 
     /*
       Map all states that can only be reached after reaching the goal
@@ -71,7 +79,8 @@ public:
         double max_time,
         PickSplit pick,
         utils::RandomNumberGenerator &rng,
-        utils::LogProxy &log);
+        utils::LogProxy &log,
+        SharedRefinementLimits *shared_limits = nullptr);
     ~CEGAR();
 
     CEGAR(const CEGAR &) = delete;
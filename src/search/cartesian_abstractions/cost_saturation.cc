@@ -5,6 +5,7 @@
 #include "cartesian_heuristic_function.h"
 #include "cegar.h"
 #include "refinement_hierarchy.h"
+#include "shared_refinement_limits.h"
 #include "subtask_generators.h"
 #include "transition_system.h"
 #include "utils.h"
@@ -14,9 +15,14 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
+#include "../utils/rng.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <limits>
+#include <mutex>
 
 using namespace std;
 
@@ -88,6 +94,7 @@ CostSaturation::CostSaturation(
     double max_time,
     bool use_general_costs,
     PickSplit pick_split,
+    int num_threads,
     utils::RandomNumberGenerator &rng,
     utils::LogProxy &log)
     : subtask_generators(subtask_generators),
@@ -96,6 +103,7 @@ CostSaturation::CostSaturation(
       max_time(max_time),
       use_general_costs(use_general_costs),
       pick_split(pick_split),
+      num_threads(num_threads),
       rng(rng),
       log(log),
       num_abstractions(0),
@@ -129,11 +137,21 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
         };
 
     utils::reserve_extra_memory_padding(memory_padding_in_mb);
-    for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
-        SharedTasks subtasks = subtask_generator->get_subtasks(task, log);
-        build_abstractions(subtasks, timer, should_abort);
-        if (should_abort())
-            break;
+    if (num_threads == 1) {
+        for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
+            SharedTasks subtasks = subtask_generator->get_subtasks(task, log);
+            build_abstractions(subtasks, timer, should_abort);
+            if (should_abort())
+                break;
+        }
+    } else {
+        SharedTasks subtasks;
+        for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
+            SharedTasks generated_subtasks = subtask_generator->get_subtasks(task, log);
+            subtasks.insert(
+                subtasks.end(), generated_subtasks.begin(), generated_subtasks.end());
+        }
+        build_abstractions_in_parallel(subtasks, timer, initial_state);
     }
     if (utils::extra_memory_padding_is_reserved())
         utils::release_extra_memory_padding();
@@ -187,6 +205,33 @@ bool CostSaturation::state_is_dead_end(const State &state) const {
     return false;
 }
 
+void CostSaturation::add_heuristic_function(
+    unique_ptr<Abstraction> abstraction, const vector<int> &costs) {
+    ++num_abstractions;
+    num_states += abstraction->get_num_states();
+    num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
+
+    vector<int> init_distances = compute_distances(
+        abstraction->get_transition_system().get_outgoing_transitions(),
+        costs,
+        {abstraction->get_initial_state().get_id()});
+    vector<int> goal_distances = compute_distances(
+        abstraction->get_transition_system().get_incoming_transitions(),
+        costs,
+        abstraction->get_goals());
+    vector<int> saturated_costs = compute_saturated_costs(
+        abstraction->get_transition_system(),
+        init_distances,
+        goal_distances,
+        use_general_costs);
+
+    heuristic_functions.emplace_back(
+        abstraction->extract_refinement_hierarchy(),
+        move(goal_distances));
+
+    reduce_remaining_costs(saturated_costs);
+}
+
 void CostSaturation::build_abstractions(
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
@@ -206,32 +251,9 @@ void CostSaturation::build_abstractions(
             rng,
             log);
 
-        unique_ptr<Abstraction> abstraction = cegar.extract_abstraction();
-        ++num_abstractions;
-        num_states += abstraction->get_num_states();
-        num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
-        assert(num_states <= max_states);
-
         vector<int> costs = task_properties::get_operator_costs(TaskProxy(*subtask));
-        vector<int> init_distances = compute_distances(
-            abstraction->get_transition_system().get_outgoing_transitions(),
-            costs,
-            {abstraction->get_initial_state().get_id()});
-        vector<int> goal_distances = compute_distances(
-            abstraction->get_transition_system().get_incoming_transitions(),
-            costs,
-            abstraction->get_goals());
-        vector<int> saturated_costs = compute_saturated_costs(
-            abstraction->get_transition_system(),
-            init_distances,
-            goal_distances,
-            use_general_costs);
-
-        heuristic_functions.emplace_back(
-            abstraction->extract_refinement_hierarchy(),
-            move(goal_distances));
-
-        reduce_remaining_costs(saturated_costs);
+        add_heuristic_function(cegar.extract_abstraction(), costs);
+        assert(num_states <= max_states);
 
         if (should_abort())
             break;
@@ -240,6 +262,95 @@ void CostSaturation::build_abstractions(
     }
 }
 
+void CostSaturation::build_abstractions_in_parallel(
+    const vector<shared_ptr<AbstractTask>> &subtasks,
+    const utils::CountdownTimer &timer,
+    const State &initial_state) {
+    int num_subtasks = subtasks.size();
+    if (log.is_at_least_normal()) {
+        log << "Build " << num_subtasks << " abstractions with "
+            << num_threads << " threads." << endl;
+    }
+
+    /* Seed one RNG per subtask in advance to make the abstractions
+       independent of the order in which the threads process them. */
+    vector<int> seeds;
+    seeds.reserve(num_subtasks);
+    for (int i = 0; i < num_subtasks; ++i) {
+        seeds.push_back(rng.random(numeric_limits<int>::max()));
+    }
+
+    SharedRefinementLimits shared_limits(max_states, max_non_looping_transitions);
+    atomic<bool> initial_state_is_dead_end(false);
+
+    // The following variables are protected by saturation_mutex.
+    mutex saturation_mutex;
+    vector<unique_ptr<Abstraction>> abstractions(num_subtasks);
+    vector<bool> is_finished(num_subtasks, false);
+    int num_saturated = 0;
+
+    /*
+      Saturated cost partitioning must process the abstractions in the
+      order of the subtasks. The thread that finishes the next abstraction
+      in this order saturates it together with all directly following
+      abstractions that are already finished. This way, we only keep a
+      few abstractions in memory at the same time.
+    */
+    auto finish_subtask = [&](int i, unique_ptr<Abstraction> &&abstraction) {
+        lock_guard<mutex> lock(saturation_mutex);
+        abstractions[i] = move(abstraction);
+        is_finished[i] = true;
+        while (num_saturated < num_subtasks && is_finished[num_saturated]) {
+            unique_ptr<Abstraction> next = move(abstractions[num_saturated]);
+            ++num_saturated;
+            if (!next || initial_state_is_dead_end)
+                continue;
+            if (log.is_at_least_verbose()) {
+                next->print_statistics();
+            }
+            vector<int> costs = remaining_costs;
+            add_heuristic_function(move(next), costs);
+            if (state_is_dead_end(initial_state))
+                initial_state_is_dead_end = true;
+        }
+    };
+
+    utils::parallel_for(
+        num_threads, num_subtasks,
+        [&](int i) {
+            if (initial_state_is_dead_end || shared_limits.is_exhausted() ||
+                timer.is_expired() || !utils::extra_memory_padding_is_reserved()) {
+                finish_subtask(i, nullptr);
+                return;
+            }
+            /* Like in the sequential case, we divide the remaining resources
+               evenly among the remaining subtasks, but the leftovers of
+               small abstractions remain in the shared pool. Since the
+               timer measures the CPU time of all threads, each subtask may
+               use the time of all threads. */
+            int num_remaining_subtasks = num_subtasks - i;
+            double max_subtask_time = min(
+                static_cast<double>(timer.get_remaining_time()),
+                timer.get_remaining_time() * num_threads / num_remaining_subtasks);
+            // The log is not thread-safe, so the workers don't log anything.
+            utils::LogProxy silent_log = utils::get_silent_log();
+            utils::RandomNumberGenerator subtask_rng(seeds[i]);
+            CEGAR cegar(
+                subtasks[i],
+                max(1, shared_limits.get_num_remaining_states() /
+                    num_remaining_subtasks),
+                max(1, shared_limits.get_num_remaining_non_looping_transitions() /
+                    num_remaining_subtasks),
+                max_subtask_time,
+                pick_split,
+                subtask_rng,
+                silent_log,
+                &shared_limits);
+            finish_subtask(i, cegar.extract_abstraction());
+        });
+    assert(num_saturated == num_subtasks);
+}
+
 void CostSaturation::print_statistics(utils::Duration init_time) const {
     if (log.is_at_least_normal()) {
         log << "Done initializing additive Cartesian heuristic" << endl;
@@ -15,6 +15,7 @@ class LogProxy;
 }
 
 namespace cartesian_abstractions {
+class Abstraction;
 class CartesianHeuristicFunction;
 class SubtaskGenerator;
 
@@ -24,6 +25,15 @@ class SubtaskGenerator;
   RefinementHierarchies from Abstractions to
   CartesianHeuristicFunctions, allow extracting
   CartesianHeuristicFunctions into AdditiveCartesianHeuristic.
+
+  With more than one thread, we first collect the subtasks of all
+  SubtaskGenerators and compute their Abstractions concurrently for the
+  original operator costs, drawing from a shared pool of states,
+  transitions and time. Afterwards, we compute saturated cost
+  partitioning over the finished Abstractions sequentially in the order
+  of the subtasks as soon as they become available. Since the
+  transitions of a Cartesian abstraction do not depend on operator
+  costs, the result is admissible as well.
 */
 class CostSaturation {
     const std::vector<std::shared_ptr<SubtaskGenerator>> subtask_generators;
@@ -32,6 +42,7 @@ class CostSaturation {
     const double max_time;
     const bool use_general_costs;
     const PickSplit pick_split;
+    const int num_threads;
     utils::RandomNumberGenerator &rng;
     utils::LogProxy &log;
 
@@ -46,10 +57,17 @@ class CostSaturation {
     std::shared_ptr<AbstractTask> get_remaining_costs_task(
         std::shared_ptr<AbstractTask> &parent) const;
     bool state_is_dead_end(const State &state) const;
+    void add_heuristic_function(
+        std::unique_ptr<Abstraction> abstraction,
+        const std::vector<int> &costs);
     void build_abstractions(
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
         std::function<bool()> should_abort);
+    void build_abstractions_in_parallel(
+        const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
+        const utils::CountdownTimer &timer,
+        const State &initial_state);
     void print_statistics(utils::Duration init_time) const;
 
 public:
@@ -60,6 +78,7 @@ public:
         double max_time,
         bool use_general_costs,
         PickSplit pick_split,
+        int num_threads,
         utils::RandomNumberGenerator &rng,
         utils::LogProxy &log);
 
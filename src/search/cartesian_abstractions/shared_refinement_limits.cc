@@ -0,0 +1,37 @@
+#include "shared_refinement_limits.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace cartesian_abstractions {
+SharedRefinementLimits::SharedRefinementLimits(
+    int max_states, int max_non_looping_transitions)
+    : max_states(max_states),
+      max_non_looping_transitions(max_non_looping_transitions),
+      num_states(0),
+      num_non_looping_transitions(0) {
+}
+
+void SharedRefinementLimits::add(
+    int num_new_states, int num_new_non_looping_transitions) {
+    assert(num_new_states >= 0);
+    num_states += num_new_states;
+    // Refinements may remove transitions, so this number can be negative.
+    num_non_looping_transitions += num_new_non_looping_transitions;
+}
+
+bool SharedRefinementLimits::is_exhausted() const {
+    return num_states >= max_states ||
+           num_non_looping_transitions >= max_non_looping_transitions;
+}
+
+int SharedRefinementLimits::get_num_remaining_states() const {
+    return max(0, max_states - num_states);
+}
+
+int SharedRefinementLimits::get_num_remaining_non_looping_transitions() const {
+    return max(0, max_non_looping_transitions - num_non_looping_transitions);
+}
+}
@@ -0,0 +1,30 @@
+#ifndef CARTESIAN_ABSTRACTIONS_SHARED_REFINEMENT_LIMITS_H
+#define CARTESIAN_ABSTRACTIONS_SHARED_REFINEMENT_LIMITS_H
+
+#include <atomic>
+
+namespace cartesian_abstractions {
+/*
+  Pool of abstract states and non-looping transitions that is shared by
+  all CEGAR instances that refine abstractions concurrently. Each CEGAR
+  instance reports how its abstraction grows and all instances stop
+  refining once the pool is exhausted.
+*/
+class SharedRefinementLimits {
+    const int max_states;
+    const int max_non_looping_transitions;
+    std::atomic<int> num_states;
+    std::atomic<int> num_non_looping_transitions;
+
+public:
+    SharedRefinementLimits(int max_states, int max_non_looping_transitions);
+
+    void add(int num_new_states, int num_new_non_looping_transitions);
+    bool is_exhausted() const;
+
+    int get_num_remaining_states() const;
+    int get_num_remaining_non_looping_transitions() const;
+};
+}
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef CARTESIAN_ABSTRACTIONS_SLICE_ARENA_H
+#define CARTESIAN_ABSTRACTIONS_SLICE_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace cartesian_abstractions {
+/*
+  Store a sequence of entries ("slice") for each abstract state in a few
+  large chunks of memory instead of using a separate vector per state.
+  This saves the per-vector bookkeeping and allocator overhead, which
+  dominates memory usage for abstractions with millions of states.
+
+  During refinement, each slice occupies a contiguous range of a chunk,
+  possibly with some spare capacity. If a slice outgrows its range, we
+  move it to a new range with twice the capacity at the end of the
+  newest chunk and the old range becomes unused. Once the unused
+  entries exceed a quarter of the used ones or when compact() is
+  called, we slide all slices towards the front of the chunks (ordered
+  by their position in memory) until there are no gaps between them,
+  and free the chunks that become empty. This needs no additional
+  memory. Afterwards, the chunks store a compressed sparse row (CSR)
+  representation whose rows (the slices) are ordered by their position
+  in memory.
+
+  All modifying operations invalidate previously returned Slices.
+*/
+template<typename T>
+class SliceArena {
+    struct SliceInfo {
+        int chunk;
+        int start;
+        int size;
+        int capacity;
+
+        SliceInfo()
+            : chunk(-1), start(0), size(0), capacity(0) {
+        }
+    };
+
+    static const int MIN_CHUNK_SIZE = 1 << 16;
+    static const int MIN_SLICE_CAPACITY = 4;
+
+    // Value for unused entries. Avoids requiring a default constructor.
+    const T unused_entry;
+    /* The ranges of all slices lie in [0, size()) of their chunk. We
+       never let chunks grow beyond their capacity to keep pointers into
+       them valid. */
+    std::vector<std::vector<T>> chunks;
+    std::vector<SliceInfo> slices;
+    std::size_t num_entries;
+    std::size_t num_unused_entries;
+
+    T *get_first(const SliceInfo &slice) {
+        return chunks[slice.chunk].data() + slice.start;
+    }
+
+    // Return (chunk, start) of a new range of the given size.
+    std::pair<int, int> allocate(int capacity) {
+        if (chunks.empty() ||
+            chunks.back().capacity() - chunks.back().size() <
+            static_cast<std::size_t>(capacity)) {
+            /* Let chunks grow with the arena to bound the memory that is
+               wasted at the ends of chunks. */
+            std::size_t chunk_size = std::max(
+                num_entries / 8,
+                static_cast<std::size_t>(std::max(MIN_CHUNK_SIZE, capacity)));
+            chunks.emplace_back();
+            chunks.back().reserve(chunk_size);
+        }
+        std::vector<T> &chunk = chunks.back();
+        int start = chunk.size();
+        chunk.resize(start + capacity, unused_entry);
+        return {static_cast<int>(chunks.size()) - 1, start};
+    }
+
+    bool try_to_grow_in_place(SliceInfo &slice, int new_capacity) {
+        if (slice.capacity == 0 ||
+            slice.chunk != static_cast<int>(chunks.size()) - 1)
+            return false;
+        std::vector<T> &chunk = chunks.back();
+        std::size_t end = slice.start + slice.capacity;
+        std::size_t new_end = slice.start + new_capacity;
+        if (end != chunk.size() || new_end > chunk.capacity())
+            return false;
+        chunk.resize(new_end, unused_entry);
+        slice.capacity = new_capacity;
+        return true;
+    }
+
+    void grow(int slice_id) {
+        if (4 * num_unused_entries > num_entries &&
+            num_unused_entries >= static_cast<std::size_t>(MIN_CHUNK_SIZE)) {
+            compact();
+        }
+        SliceInfo &slice = slices[slice_id];
+        int new_capacity = std::max(MIN_SLICE_CAPACITY, 2 * slice.capacity);
+        if (try_to_grow_in_place(slice, new_capacity))
+            return;
+        std::pair<int, int> range = allocate(new_capacity);
+        T *new_first = chunks[range.first].data() + range.second;
+        if (slice.size > 0) {
+            const T *first = get_first(slice);
+            std::copy(first, first + slice.size, new_first);
+        }
+        num_unused_entries += slice.capacity;
+        slice.chunk = range.first;
+        slice.start = range.second;
+        slice.capacity = new_capacity;
+    }
+
+public:
+    class Slice {
+        const T *first;
+        const T *last;
+    public:
+        Slice(const T *first, const T *last)
+            : first(first), last(last) {
+        }
+
+        const T *begin() const {
+            return first;
+        }
+
+        const T *end() const {
+            return last;
+        }
+
+        std::size_t size() const {
+            return last - first;
+        }
+
+        bool empty() const {
+            return first == last;
+        }
+    };
+
+    explicit SliceArena(const T &unused_entry)
+        : unused_entry(unused_entry),
+          num_entries(0),
+          num_unused_entries(0) {
+    }
+
+    // Return the number of slices.
+    std::size_t size() const {
+        return slices.size();
+    }
+
+    void add_slice() {
+        slices.emplace_back();
+    }
+
+    Slice operator[](int slice_id) const {
+        assert(slice_id >= 0 && slice_id < static_cast<int>(slices.size()));
+        const SliceInfo &slice = slices[slice_id];
+        if (slice.size == 0)
+            return Slice(nullptr, nullptr);
+        const T *first = chunks[slice.chunk].data() + slice.start;
+        return Slice(first, first + slice.size);
+    }
+
+    void push_back(int slice_id, const T &entry) {
+        assert(slice_id >= 0 && slice_id < static_cast<int>(slices.size()));
+        if (slices[slice_id].size == slices[slice_id].capacity)
+            grow(slice_id);
+        SliceInfo &slice = slices[slice_id];
+        get_first(slice)[slice.size++] = entry;
+        ++num_entries;
+    }
+
+    // Remove all entries satisfying pred and return their number.
+    template<typename Predicate>
+    int remove_if(int slice_id, Predicate pred) {
+        SliceInfo &slice = slices[slice_id];
+        if (slice.size == 0)
+            return 0;
+        T *first = get_first(slice);
+        T *new_last = std::remove_if(first, first + slice.size, pred);
+        int num_removed = (first + slice.size) - new_last;
+        slice.size -= num_removed;
+        num_entries -= num_removed;
+        return num_removed;
+    }
+
+    /*
+      Copy the entries of the slice into a vector and clear the slice.
+      The slice keeps its capacity.
+    */
+    std::vector<T> extract(int slice_id) {
+        SliceInfo &slice = slices[slice_id];
+        std::vector<T> entries;
+        if (slice.size > 0) {
+            const T *first = get_first(slice);
+            entries.assign(first, first + slice.size);
+        }
+        num_entries -= slice.size;
+        slice.size = 0;
+        return entries;
+    }
+
+    // Remove all spare capacity and unused ranges.
+    void compact() {
+        std::vector<int> slice_ids;
+        slice_ids.reserve(slices.size());
+        for (std::size_t slice_id = 0; slice_id < slices.size(); ++slice_id) {
+            const SliceInfo &slice = slices[slice_id];
+            if (slice.size > 0) {
+                slice_ids.push_back(slice_id);
+            } else {
+                slices[slice_id] = SliceInfo();
+            }
+        }
+        std::sort(slice_ids.begin(), slice_ids.end(),
+                  [&](int id1, int id2) {
+                      const SliceInfo &slice1 = slices[id1];
+                      const SliceInfo &slice2 = slices[id2];
+                      return std::make_pair(slice1.chunk, slice1.start) <
+                             std::make_pair(slice2.chunk, slice2.start);
+                  });
+
+        /*
+          Since we process the slices by increasing position, the
+          destination of each slice never lies behind its source: if the
+          current destination chunk has not enough space left, the source
+          must lie in a later chunk.
+        */
+        int chunk_id = 0;
+        int start = 0;
+        for (int slice_id : slice_ids) {
+            SliceInfo &slice = slices[slice_id];
+            if (chunks[chunk_id].capacity() - start <
+                static_cast<std::size_t>(slice.size)) {
+                chunks[chunk_id].resize(start, unused_entry);
+                ++chunk_id;
+                start = 0;
+            }
+            assert(std::make_pair(chunk_id, start) <=
+                   std::make_pair(slice.chunk, slice.start));
+            std::vector<T> &chunk = chunks[chunk_id];
+            std::size_t end = start + slice.size;
+            if (chunk.size() < end) {
+                // The source lies in a later chunk.
+                chunk.resize(end, unused_entry);
+            }
+            const T *first = get_first(slice);
+            std::copy(first, first + slice.size, chunk.data() + start);
+            slice.chunk = chunk_id;
+            slice.start = start;
+            slice.capacity = slice.size;
+            start += slice.size;
+        }
+        if (!chunks.empty()) {
+            chunks[chunk_id].resize(start, unused_entry);
+            chunks.resize(chunk_id + 1);
+        }
+        num_unused_entries = 0;
+    }
+
+    std::size_t get_num_entries() const {
+        return num_entries;
+    }
+
+    // Return the number of entries and spare capacity held in memory.
+    std::size_t get_num_allocated_entries() const {
+        std::size_t num_allocated_entries = 0;
+        for (const std::vector<T> &chunk : chunks) {
+            num_allocated_entries += chunk.capacity();
+        }
+        return num_allocated_entries;
+    }
+};
+}
+
+#endif
@@ -69,18 +69,21 @@ static int lookup_value(const vector<FactPair> &facts, int var) {
 }
 
 static void remove_transitions_with_given_target(
-    Transitions &transitions, int state_id) {
-    auto new_end = remove_if(
-        transitions.begin(), transitions.end(),
+    TransitionArena &transitions, int src_id, int state_id) {
+    int num_removed = transitions.remove_if(
+        src_id,
         [state_id](const Transition &t) {return t.target_id == state_id;});
-    assert(new_end != transitions.end());
-    transitions.erase(new_end, transitions.end());
+    utils::unused_variable(num_removed);
+    assert(num_removed > 0);
 }
 
 
 TransitionSystem::TransitionSystem(const OperatorsProxy &ops)
     : preconditions_by_operator(get_preconditions_by_operator(ops)),
       postconditions_by_operator(get_postconditions_by_operator(ops)),
+      incoming(Transition(UNDEFINED, UNDEFINED)),
+      outgoing(Transition(UNDEFINED, UNDEFINED)),
+      loops(UNDEFINED),
       num_non_loops(0),
       num_loops(0) {
     add_loops_in_trivial_abstraction();
@@ -95,10 +98,9 @@ int TransitionSystem::get_postcondition_value(int op_id, int var) const {
 }
 
 void TransitionSystem::enlarge_vectors_by_one() {
-    int new_num_states = get_num_states() + 1;
-    outgoing.resize(new_num_states);
-    incoming.resize(new_num_states);
-    loops.resize(new_num_states);
+    outgoing.add_slice();
+    incoming.add_slice();
+    loops.add_slice();
 }
 
 void TransitionSystem::add_loops_in_trivial_abstraction() {
@@ -112,14 +114,14 @@ void TransitionSystem::add_loops_in_trivial_abstraction() {
 
 void TransitionSystem::add_transition(int src_id, int op_id, int target_id) {
     assert(src_id != target_id);
-    outgoing[src_id].emplace_back(op_id, target_id);
-    incoming[target_id].emplace_back(op_id, src_id);
+    outgoing.push_back(src_id, Transition(op_id, target_id));
+    incoming.push_back(target_id, Transition(op_id, src_id));
     ++num_non_loops;
 }
 
 void TransitionSystem::add_loop(int state_id, int op_id) {
     assert(utils::in_bounds(state_id, loops));
-    loops[state_id].push_back(op_id);
+    loops.push_back(state_id, op_id);
     ++num_loops;
 }
 
@@ -136,7 +138,7 @@ void TransitionSystem::rewire_incoming_transitions(
         int u_id = transition.target_id;
         bool is_new_state = updated_states.insert(u_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(outgoing[u_id], v1_id);
+            remove_transitions_with_given_target(outgoing, u_id, v1_id);
         }
     }
     num_non_loops -= old_incoming.size();
@@ -181,7 +183,7 @@ void TransitionSystem::rewire_outgoing_transitions(
         int w_id = transition.target_id;
         bool is_new_state = updated_states.insert(w_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(incoming[w_id], v1_id);
+            remove_transitions_with_given_target(incoming, w_id, v1_id);
         }
     }
     num_non_loops -= old_outgoing.size();
@@ -277,9 +279,9 @@ void TransitionSystem::rewire(
     const AbstractStates &states, int v_id,
     const AbstractState &v1, const AbstractState &v2, int var) {
     // Retrieve old transitions and make space for new transitions.
-    Transitions old_incoming = move(incoming[v_id]);
-    Transitions old_outgoing = move(outgoing[v_id]);
-    Loops old_loops = move(loops[v_id]);
+    Transitions old_incoming = incoming.extract(v_id);
+    Transitions old_outgoing = outgoing.extract(v_id);
+    Loops old_loops = loops.extract(v_id);
     enlarge_vectors_by_one();
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
@@ -294,15 +296,21 @@ void TransitionSystem::rewire(
     rewire_loops(old_loops, v1, v2, var);
 }
 
-const vector<Transitions> &TransitionSystem::get_incoming_transitions() const {
+void TransitionSystem::compact() {
+    incoming.compact();
+    outgoing.compact();
+    loops.compact();
+}
+
+const TransitionArena &TransitionSystem::get_incoming_transitions() const {
     return incoming;
 }
 
-const vector<Transitions> &TransitionSystem::get_outgoing_transitions() const {
+const TransitionArena &TransitionSystem::get_outgoing_transitions() const {
     return outgoing;
 }
 
-const vector<Loops> &TransitionSystem::get_loops() const {
+const LoopArena &TransitionSystem::get_loops() const {
     return loops;
 }
 
@@ -340,6 +348,12 @@ void TransitionSystem::print_statistics(utils::LogProxy &log) const {
         assert(get_num_non_loops() == total_outgoing_transitions);
         log << "Looping transitions: " << total_loops << endl;
         log << "Non-looping transitions: " << total_outgoing_transitions << endl;
+        size_t num_allocated_entries =
+            incoming.get_num_allocated_entries() +
+            outgoing.get_num_allocated_entries();
+        log << "Allocated transition entries: " << num_allocated_entries
+            << " (" << num_allocated_entries * sizeof(Transition) / 1024
+            << " KB)" << endl;
     }
 }
 }
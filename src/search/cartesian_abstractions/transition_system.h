@@ -1,6 +1,8 @@
 #ifndef CARTESIAN_ABSTRACTIONS_TRANSITION_SYSTEM_H
 #define CARTESIAN_ABSTRACTIONS_TRANSITION_SYSTEM_H
 
+#include "slice_arena.h"
+#include "transition.h"
 #include "types.h"
 
 #include <vector>
@@ -15,17 +17,21 @@ class LogProxy;
 namespace cartesian_abstractions {
 /*
   Rewire transitions after each split.
+
+  The transitions and self-loops of all abstract states are stored in
+  SliceArenas. Call compact() once refinement is finished to obtain a
+  gap-free CSR layout for the distance computations.
 */
 class TransitionSystem {
     const std::vector<std::vector<FactPair>> preconditions_by_operator;
     const std::vector<std::vector<FactPair>> postconditions_by_operator;
 
     // Transitions from and to other abstract states.
-    std::vector<Transitions> incoming;
-    std::vector<Transitions> outgoing;
+    TransitionArena incoming;
+    TransitionArena outgoing;
 
     // Store self-loops (operator indices) separately to save space.
-    std::vector<Loops> loops;
+    LoopArena loops;
 
     int num_non_loops;
     int num_loops;
@@ -59,9 +65,12 @@ public:
         const AbstractStates &states, int v_id,
         const AbstractState &v1, const AbstractState &v2, int var);
 
-    const std::vector<Transitions> &get_incoming_transitions() const;
-    const std::vector<Transitions> &get_outgoing_transitions() const;
-    const std::vector<Loops> &get_loops() const;
+    // Store transitions without spare capacity.
+    void compact();
+
+    const TransitionArena &get_incoming_transitions() const;
+    const TransitionArena &get_outgoing_transitions() const;
+    const LoopArena &get_loops() const;
 
     int get_num_states() const;
     int get_num_operators() const;
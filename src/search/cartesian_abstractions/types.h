@@ -9,12 +9,16 @@
 namespace cartesian_abstractions {
 class AbstractState;
 struct Transition;
+template<typename T>
+class SliceArena;
 
 using AbstractStates = std::vector<std::unique_ptr<AbstractState>>;
 using Goals = std::unordered_set<int>;
 using NodeID = int;
 using Loops = std::vector<int>;
 using Transitions = std::vector<Transition>;
+using LoopArena = SliceArena<int>;
+using TransitionArena = SliceArena<Transition>;
 
 const int UNDEFINED = -1;
 
@@ -55,6 +55,13 @@ const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     return result;
 }
 
+void EvaluationContext::set_result(
+    Evaluator *evaluator, const EvaluationResult &result) {
+    EvaluationResult &cached_result = cache[evaluator];
+    assert(cached_result.is_uninitialized());
+    cached_result = result;
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
@@ -89,6 +89,12 @@ public:
         SearchStatistics *statistics = nullptr, bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+    /*
+      Store a result that was computed outside of this context, e.g., by a
+      copy of the evaluator in another thread. The context must not contain
+      a result for the evaluator yet.
+    */
+    void set_result(Evaluator *eval, const EvaluationResult &result);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
     int get_g_value() const;
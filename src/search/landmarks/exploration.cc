@@ -9,7 +9,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <limits>
 
 using namespace std;
 
@@ -25,7 +24,8 @@ namespace landmarks {
 
 // Construction and destruction
 Exploration::Exploration(const TaskProxy &task_proxy, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+    : task_proxy(task_proxy),
+      reachability_without_exclusions_is_computed(false) {
     if (log.is_at_least_normal()) {
         log << "Initializing Exploration..." << endl;
     }
@@ -54,6 +54,7 @@ Exploration::Exploration(const TaskProxy &task_proxy, utils::LogProxy &log)
         num_unary_ops += axiom.get_effects().size();
     }
     unary_operators.reserve(num_unary_ops);
+    unary_operators_by_operator.resize(operators.size() + axioms.size());
 
     // Build unary operators for operators and axioms.
     for (OperatorProxy op : operators)
@@ -86,143 +87,253 @@ void Exploration::build_unary_operators(const OperatorProxy &op) {
         FactProxy effect_fact = effect.get_fact();
         Proposition *effect_proposition = &propositions[effect_fact.get_variable().get_id()][effect_fact.get_value()];
         int op_or_axiom_id = get_operator_or_axiom_id(op);
-        unary_operators.emplace_back(precondition, effect_proposition, op_or_axiom_id);
+        unary_operators.emplace_back(precondition, effect_proposition,
+                                     op_or_axiom_id, !effect_conditions.empty());
+        UnaryOperator *unary_op = &unary_operators.back();
 
         // Cross-reference unary operators.
         for (Proposition *pre : precondition) {
-            pre->precondition_of.push_back(&unary_operators.back());
+            pre->precondition_of.push_back(unary_op);
         }
+        effect_proposition->achievers.push_back(unary_op);
+        get_unary_operators(op_or_axiom_id).push_back(unary_op);
 
         precondition.clear();
         precondition_facts2.clear();
     }
 }
 
-/*
-  This function initializes the priority queue and the information associated
-  with propositions and unary operators for the relaxed exploration. Unary
-  operators that are not allowed to be applied due to exclusions are marked by
-  setting their *excluded* flag.
-*/
-void Exploration::setup_exploration_queue(
-    const State &state, const vector<FactPair> &excluded_props,
-    const vector<int> &excluded_op_ids) {
-    prop_queue.clear();
-
-    // Reset reachability information.
-    for (auto &propositions_for_variable : propositions) {
-        for (auto &prop : propositions_for_variable) {
-            prop.reached = false;
-        }
+vector<UnaryOperator *> &Exploration::get_unary_operators(int op_or_axiom_id) {
+    if (op_or_axiom_id < 0) {
+        int num_operators = task_proxy.get_operators().size();
+        return unary_operators_by_operator[num_operators - op_or_axiom_id - 1];
     }
+    return unary_operators_by_operator[op_or_axiom_id];
+}
 
-    for (const FactPair &fact : excluded_props) {
-        propositions[fact.var][fact.value].excluded = true;
+void Exploration::reach_without_exclusions(Proposition *prop) {
+    if (!prop->reached) {
+        prop->reached = true;
+        prop->reach_index = prop_queue.size();
+        prop_queue.push_back(prop);
     }
+}
 
-    // Set facts that are true in the current state as reached.
-    for (FactProxy fact : state) {
+/*
+  Computes the relaxed exploration from the initial state without any
+  exclusions and the supports of all propositions. An operator supports its
+  effect if its last precondition is reached before the effect. This holds
+  at least for the operator that reaches the effect first.
+*/
+void Exploration::compute_reachability_without_exclusions() {
+    prop_queue.clear();
+    for (FactProxy fact : task_proxy.get_initial_state()) {
         Proposition *init_prop =
             &propositions[fact.get_variable().get_id()][fact.get_value()];
-        enqueue_if_necessary(init_prop);
+        reach_without_exclusions(init_prop);
+        // The initial state supports the proposition.
+        init_prop->num_supports = 1;
     }
 
-    /*
-      Unary operators derived from operators that are excluded or achieve
-      an excluded proposition *unconditionally* must be marked as excluded.
-
-      Note that we in general cannot exclude all unary operators derived from
-      operators that achieve an excluded propositon *conditionally*:
-      Given an operator with uncoditional effect e1 and conditional effect e2
-      with condition c yields unary operators uo1: {} -> e1 and uo2: c -> e2.
-      Excluding both would not allow us to achieve e1 when excluding
-      proposition e2. We instead only mark uo2 as excluded (see below when
-      looping over all unary operators). Note however that this can lead to
-      an overapproximation, e.g. if the effect e1 also has condition c.
-    */
-    unordered_set<int> op_ids_to_mark(excluded_op_ids.begin(),
-                                      excluded_op_ids.end());
-    for (OperatorProxy op : task_proxy.get_operators()) {
-        for (EffectProxy effect : op.get_effects()) {
-            if (effect.get_conditions().empty()
-                && propositions[effect.get_fact().get_variable().get_id()]
-                [effect.get_fact().get_value()].excluded) {
-                op_ids_to_mark.insert(op.get_id());
-                break;
+    auto apply = [this](UnaryOperator *op, int last_precondition_index) {
+            op->reachable = true;
+            reach_without_exclusions(op->effect);
+            if (op->effect->reach_index > last_precondition_index) {
+                op->is_support = true;
+                ++op->effect->num_supports;
+            }
+        };
+
+    for (UnaryOperator &op : unary_operators) {
+        if (op.num_preconditions == 0) {
+            apply(&op, -1);
+        }
+    }
+    // The queue grows during the loop.
+    for (size_t i = 0; i < prop_queue.size(); ++i) {
+        for (UnaryOperator *op : prop_queue[i]->precondition_of) {
+            --op->unsatisfied_preconditions;
+            assert(op->unsatisfied_preconditions >= 0);
+            if (op->unsatisfied_preconditions == 0) {
+                apply(op, i);
             }
         }
     }
+    prop_queue.clear();
 
-    // Initialize operator data, queue effects of precondition-free operators.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-
-        /*
-          Aside from UnaryOperators derived from operators with an id in
-          op_ids_to_mark we also exclude UnaryOperators that have an excluded
-          proposition as effect (see comment when building *op_ids_to_mark*).
-        */
-        if (op.effect->excluded
-            || op_ids_to_mark.count(op.op_or_axiom_id)) {
-            // Operator will not be applied during relaxed exploration.
-            op.excluded = true;
-            continue;
+    reached_without_exclusions.resize(propositions.size());
+    for (size_t var_id = 0; var_id < propositions.size(); ++var_id) {
+        reached_without_exclusions[var_id].resize(propositions[var_id].size());
+        for (size_t value = 0; value < propositions[var_id].size(); ++value) {
+            Proposition &prop = propositions[var_id][value];
+            prop.num_supports_without_exclusions = prop.num_supports;
+            reached_without_exclusions[var_id][value] = prop.reached;
         }
-        op.excluded = false; // Reset from previous exploration.
+    }
+    reachability_without_exclusions_is_computed = true;
+}
 
-        if (op.unsatisfied_preconditions == 0) {
-            enqueue_if_necessary(op.effect);
+void Exploration::remove_support(Proposition *prop) {
+    assert(prop->num_supports > 0);
+    if (prop->num_supports == prop->num_supports_without_exclusions) {
+        touched_props.push_back(prop);
+    }
+    --prop->num_supports;
+    if (prop->num_supports == 0) {
+        prop->reached = false;
+        prop_queue.push_back(prop);
+    }
+}
+
+void Exploration::exclude_operator(UnaryOperator *op) {
+    if (!op->excluded) {
+        op->excluded = true;
+        touched_ops.push_back(op);
+        if (op->is_support) {
+            remove_support(op->effect);
         }
     }
+}
+
+/*
+  Unary operators derived from operators that are excluded or achieve
+  an excluded proposition *unconditionally* must be marked as excluded.
 
-    // Reset *excluded* to false for the next exploration.
+  Note that we in general cannot exclude all unary operators derived from
+  operators that achieve an excluded propositon *conditionally*:
+  Given an operator with uncoditional effect e1 and conditional effect e2
+  with condition c yields unary operators uo1: {} -> e1 and uo2: c -> e2.
+  Excluding both would not allow us to achieve e1 when excluding
+  proposition e2. We instead only mark uo2 as excluded. Note however that
+  this can lead to an overapproximation, e.g. if the effect e1 also has
+  condition c.
+*/
+void Exploration::exclude_operators(
+    const vector<FactPair> &excluded_props,
+    const vector<int> &excluded_op_ids) {
     for (const FactPair &fact : excluded_props) {
-        propositions[fact.var][fact.value].excluded = false;
+        for (UnaryOperator *op : propositions[fact.var][fact.value].achievers) {
+            exclude_operator(op);
+            if (!op->is_conditional && op->op_or_axiom_id >= 0) {
+                for (UnaryOperator *sibling : get_unary_operators(op->op_or_axiom_id)) {
+                    exclude_operator(sibling);
+                }
+            }
+        }
+    }
+    for (int op_or_axiom_id : excluded_op_ids) {
+        for (UnaryOperator *op : get_unary_operators(op_or_axiom_id)) {
+            exclude_operator(op);
+        }
     }
 }
 
-void Exploration::relaxed_exploration() {
-    while (!prop_queue.empty()) {
-        Proposition *prop = prop_queue.front();
-        prop_queue.pop_front();
+/*
+  Propagates the retraction of the propositions in the queue to all
+  propositions that lose their last support.
+*/
+void Exploration::retract_unsupported_propositions() {
+    // The queue grows during the loop.
+    for (size_t i = 0; i < prop_queue.size(); ++i) {
+        for (UnaryOperator *op : prop_queue[i]->precondition_of) {
+            if (!op->reachable)
+                continue;
+            if (op->unsatisfied_preconditions == 0) {
+                touched_ops.push_back(op);
+                if (!op->excluded && op->is_support) {
+                    remove_support(op->effect);
+                }
+            }
+            ++op->unsatisfied_preconditions;
+        }
+    }
+}
 
-        const vector<UnaryOperator *> &triggered_operators = prop->precondition_of;
-        for (UnaryOperator *unary_op : triggered_operators) {
-            if (unary_op->excluded)
+/*
+  Reaches all retracted propositions that can still be reached by operators
+  that are not excluded and returns the remaining ones.
+*/
+vector<FactPair> Exploration::reach_retracted_propositions() {
+    vector<Proposition *> retracted_props;
+    retracted_props.swap(prop_queue);
+
+    auto reach = [this](Proposition *prop) {
+            if (!prop->reached) {
+                prop->reached = true;
+                prop_queue.push_back(prop);
+            }
+        };
+
+    for (Proposition *prop : retracted_props) {
+        for (UnaryOperator *op : prop->achievers) {
+            if (op->reachable && !op->excluded
+                && op->unsatisfied_preconditions == 0) {
+                reach(prop);
+                break;
+            }
+        }
+    }
+    // The queue grows during the loop.
+    for (size_t i = 0; i < prop_queue.size(); ++i) {
+        for (UnaryOperator *op : prop_queue[i]->precondition_of) {
+            if (!op->reachable || op->excluded)
                 continue;
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0) {
-                enqueue_if_necessary(unary_op->effect);
+            --op->unsatisfied_preconditions;
+            assert(op->unsatisfied_preconditions >= 0);
+            if (op->unsatisfied_preconditions == 0) {
+                reach(op->effect);
             }
         }
     }
+    prop_queue.clear();
+
+    vector<FactPair> unreached_props;
+    for (Proposition *prop : retracted_props) {
+        if (!prop->reached) {
+            unreached_props.push_back(prop->fact);
+        }
+    }
+    return unreached_props;
 }
 
-void Exploration::enqueue_if_necessary(Proposition *prop) {
-    if (!prop->reached) {
+void Exploration::restore_reachability_without_exclusions() {
+    for (Proposition *prop : touched_props) {
         prop->reached = true;
-        prop_queue.push_back(prop);
+        prop->num_supports = prop->num_supports_without_exclusions;
     }
+    touched_props.clear();
+    for (UnaryOperator *op : touched_ops) {
+        op->excluded = false;
+        if (op->reachable) {
+            op->unsatisfied_preconditions = 0;
+        }
+    }
+    touched_ops.clear();
 }
 
 vector<vector<bool>> Exploration::compute_relaxed_reachability(
     const vector<FactPair> &excluded_props,
     const vector<int> &excluded_op_ids) {
-    setup_exploration_queue(task_proxy.get_initial_state(),
-                            excluded_props, excluded_op_ids);
-    relaxed_exploration();
+    if (!reachability_without_exclusions_is_computed) {
+        compute_reachability_without_exclusions();
+    }
 
-    // Bundle reachability information into the return data structure.
-    vector<vector<bool>> reached;
-    reached.resize(propositions.size());
-    for (size_t var_id = 0; var_id < propositions.size(); ++var_id) {
-        reached[var_id].resize(propositions[var_id].size(), false);
-        for (size_t value = 0; value < propositions[var_id].size(); ++value) {
-            if (propositions[var_id][value].reached) {
-                reached[var_id][value] = true;
-            }
-        }
+    Exclusions exclusions(excluded_props, excluded_op_ids);
+    utils::sort_unique(exclusions.first);
+    utils::sort_unique(exclusions.second);
+    auto it = cached_unreached_props.find(exclusions);
+    if (it == cached_unreached_props.end()) {
+        exclude_operators(exclusions.first, exclusions.second);
+        retract_unsupported_propositions();
+        vector<FactPair> unreached_props = reach_retracted_propositions();
+        restore_reachability_without_exclusions();
+        it = cached_unreached_props.emplace(
+            move(exclusions), move(unreached_props)).first;
+    }
+
+    vector<vector<bool>> reached = reached_without_exclusions;
+    for (const FactPair &fact : it->second) {
+        reached[fact.var][fact.value] = false;
     }
     return reached;
 }
@@ -5,10 +5,9 @@
 
 #include "../task_proxy.h"
 
-#include "../algorithms/priority_queues.h"
+#include "../utils/hash.h"
 
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace utils {
@@ -22,13 +21,28 @@ struct UnaryOperator;
 struct Proposition {
     FactPair fact;
     std::vector<UnaryOperator *> precondition_of;
+    std::vector<UnaryOperator *> achievers;
     bool reached;
-    bool excluded;
+
+    /*
+      Position in the order in which the exploration without exclusions
+      reaches the proposition, or -1 if it is unreachable.
+    */
+    int reach_index;
+    /*
+      Number of operators that reach the proposition from propositions
+      that are reached before it (plus 1 if it holds initially). A
+      proposition stays reachable as long as one of these supports remains.
+    */
+    int num_supports;
+    int num_supports_without_exclusions;
 
     Proposition()
         : fact(FactPair::no_fact),
           reached(false),
-          excluded(false) {
+          reach_index(-1),
+          num_supports(0),
+          num_supports_without_exclusions(0) {
     }
 
     bool operator<(const Proposition &other) const {
@@ -40,31 +54,74 @@ struct UnaryOperator {
     int op_or_axiom_id;
     const int num_preconditions;
     Proposition *effect;
+    const bool is_conditional;
 
     int unsatisfied_preconditions;
     bool excluded;
+    // True iff the operator is applicable in the exploration without exclusions.
+    bool reachable;
+    // True iff the operator counts as support of its effect (see Proposition).
+    bool is_support;
     UnaryOperator(const std::vector<Proposition *> &preconditions,
-                  Proposition *eff, int op_or_axiom_id)
+                  Proposition *eff, int op_or_axiom_id, bool is_conditional)
         : op_or_axiom_id(op_or_axiom_id),
           num_preconditions(static_cast<int>(preconditions.size())),
           effect(eff),
+          is_conditional(is_conditional),
           unsatisfied_preconditions(num_preconditions),
-          excluded(false) {}
+          excluded(false),
+          reachable(false),
+          is_support(false) {}
 };
 
+/*
+  Computes relaxed reachability from the initial state when excluding
+  propositions and operators.
+
+  The exploration without exclusions is computed once. For an exploration
+  with exclusions, we retract the supports of all excluded operators and
+  propagate the retraction through the propositions that lose all their
+  supports. Since supports only come from propositions reached earlier in
+  the exploration without exclusions, the propositions that keep a support
+  are still reachable. The retracted propositions that are still reachable
+  by other operators are then reached again by a relaxed exploration
+  restricted to them. Finally, all changes are undone. Like this, each
+  exploration only touches the part of the task that depends on the
+  exclusions. Results are cached for each combination of exclusions.
+*/
 class Exploration {
     TaskProxy task_proxy;
 
     std::vector<UnaryOperator> unary_operators;
     std::vector<std::vector<Proposition>> propositions;
-    std::deque<Proposition *> prop_queue;
+    // Indexed by operator ID followed by axiom ID.
+    std::vector<std::vector<UnaryOperator *>> unary_operators_by_operator;
+    bool reachability_without_exclusions_is_computed;
+
+    std::vector<Proposition *> prop_queue;
+    std::vector<Proposition *> touched_props;
+    std::vector<UnaryOperator *> touched_ops;
+
+    std::vector<std::vector<bool>> reached_without_exclusions;
+    /*
+      Maps sorted excluded propositions and operators to the propositions
+      that are only unreachable because of the exclusions.
+    */
+    using Exclusions = std::pair<std::vector<FactPair>, std::vector<int>>;
+    utils::HashMap<Exclusions, std::vector<FactPair>> cached_unreached_props;
 
     void build_unary_operators(const OperatorProxy &op);
-    void setup_exploration_queue(
-        const State &state, const std::vector<FactPair> &excluded_props,
+    std::vector<UnaryOperator *> &get_unary_operators(int op_or_axiom_id);
+    void compute_reachability_without_exclusions();
+    void reach_without_exclusions(Proposition *prop);
+    void exclude_operators(
+        const std::vector<FactPair> &excluded_props,
         const std::vector<int> &excluded_op_ids);
-    void relaxed_exploration();
-    void enqueue_if_necessary(Proposition *prop);
+    void exclude_operator(UnaryOperator *op);
+    void remove_support(Proposition *prop);
+    void retract_unsupported_propositions();
+    std::vector<FactPair> reach_retracted_propositions();
+    void restore_reachability_without_exclusions();
 public:
     Exploration(const TaskProxy &task_proxy, utils::LogProxy &log);
 
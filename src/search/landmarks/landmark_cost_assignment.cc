@@ -247,4 +247,320 @@ double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value(
 
     return h;
 }
+
+LandmarkCombinatorialOptimalSharedCostAssignment::LandmarkCombinatorialOptimalSharedCostAssignment(
+    const vector<int> &operator_costs, const LandmarkGraph &graph)
+    : LandmarkCostAssignment(operator_costs, graph),
+      num_landmarks(0),
+      operator_landmarks(operator_costs.size()),
+      operator_is_removed(operator_costs.size(), false),
+      operator_components(operator_costs.size(), -1) {
+}
+
+void LandmarkCombinatorialOptimalSharedCostAssignment::collect_operator_landmarks() {
+    for (int op_id : relevant_operators) {
+        operator_landmarks[op_id].clear();
+    }
+    relevant_operators.clear();
+    for (int lm = 0; lm < num_landmarks; ++lm) {
+        if (landmark_is_removed[lm]) {
+            continue;
+        }
+        for (int op_id : landmark_achievers[lm]) {
+            if (operator_landmarks[op_id].empty()) {
+                relevant_operators.push_back(op_id);
+            }
+            operator_landmarks[op_id].push_back(lm);
+        }
+    }
+}
+
+bool LandmarkCombinatorialOptimalSharedCostAssignment::remove_dominated_landmarks() {
+    /*
+      Landmark lm dominates landmark other if all achievers of lm achieve
+      other. Then the constraint for other is implied in the dual LP. For
+      landmarks with the same achievers, the one with the smallest index
+      dominates the others. Since domination is transitive, it suffices to
+      look for landmarks dominated by landmarks that are not removed.
+    */
+    bool removed_any = false;
+    for (int lm = 0; lm < num_landmarks; ++lm) {
+        if (landmark_is_removed[lm]) {
+            continue;
+        }
+        const vector<int> &achievers = landmark_achievers[lm];
+        // All dominated landmarks are achieved by the achiever of lm with the fewest landmarks.
+        int op_id = *min_element(
+            achievers.begin(), achievers.end(), [this](int op1, int op2) {
+                return operator_landmarks[op1].size() <
+                operator_landmarks[op2].size();
+            });
+        for (int other : operator_landmarks[op_id]) {
+            if (other == lm || landmark_is_removed[other]) {
+                continue;
+            }
+            const vector<int> &other_achievers = landmark_achievers[other];
+            if ((other_achievers.size() > achievers.size() ||
+                 (other_achievers.size() == achievers.size() && other > lm)) &&
+                includes(other_achievers.begin(), other_achievers.end(),
+                         achievers.begin(), achievers.end())) {
+                landmark_is_removed[other] = true;
+                removed_any = true;
+            }
+        }
+    }
+    return removed_any;
+}
+
+bool LandmarkCombinatorialOptimalSharedCostAssignment::remove_dominated_operators() {
+    /*
+      Operator other dominates operator op if it achieves all landmarks of
+      op and is not more expensive. Then the constraint for op is implied
+      in the primal LP. Ties are broken by the number of landmarks, the
+      cost and the operator ID.
+    */
+    bool removed_any = false;
+    for (int op_id : relevant_operators) {
+        const vector<int> &landmarks = operator_landmarks[op_id];
+        int cost = operator_costs[op_id];
+        // All dominating operators achieve the landmark of op with the fewest achievers.
+        int lm = *min_element(
+            landmarks.begin(), landmarks.end(), [this](int lm1, int lm2) {
+                return landmark_achievers[lm1].size() <
+                landmark_achievers[lm2].size();
+            });
+        for (int other : landmark_achievers[lm]) {
+            const vector<int> &other_landmarks = operator_landmarks[other];
+            int other_cost = operator_costs[other];
+            if (other == op_id || other_cost > cost ||
+                other_landmarks.size() < landmarks.size()) {
+                continue;
+            }
+            bool is_better = other_landmarks.size() > landmarks.size() ||
+                other_cost < cost || other < op_id;
+            if (is_better &&
+                includes(other_landmarks.begin(), other_landmarks.end(),
+                         landmarks.begin(), landmarks.end())) {
+                operator_is_removed[op_id] = true;
+                removed_any = true;
+                break;
+            }
+        }
+    }
+    if (removed_any) {
+        for (int lm = 0; lm < num_landmarks; ++lm) {
+            vector<int> &achievers = landmark_achievers[lm];
+            achievers.erase(
+                remove_if(achievers.begin(), achievers.end(), [this](int op_id) {
+                              return operator_is_removed[op_id];
+                          }),
+                achievers.end());
+            assert(landmark_is_removed[lm] || !achievers.empty());
+        }
+        for (int op_id : relevant_operators) {
+            operator_is_removed[op_id] = false;
+        }
+    }
+    return removed_any;
+}
+
+void LandmarkCombinatorialOptimalSharedCostAssignment::pivot(
+    int num_rows, int num_columns, int row, int column) {
+    /*
+      The tableau represents the basic variables as x_B = rhs - T * x_N and
+      the objective as value + reduced_costs * x_N. We exchange the basic
+      variable of the row with the nonbasic variable of the column.
+    */
+    double *pivot_row = &tableau[row * num_columns];
+    double inverse = 1.0 / pivot_row[column];
+    for (int col = 0; col < num_columns; ++col) {
+        pivot_row[col] *= inverse;
+    }
+    pivot_row[column] = inverse;
+    rhs[row] *= inverse;
+    for (int r = 0; r < num_rows; ++r) {
+        double *tableau_row = &tableau[r * num_columns];
+        double factor = tableau_row[column];
+        if (r == row || factor == 0) {
+            continue;
+        }
+        for (int col = 0; col < num_columns; ++col) {
+            tableau_row[col] -= factor * pivot_row[col];
+        }
+        tableau_row[column] = -factor * inverse;
+        rhs[r] -= factor * rhs[row];
+    }
+    double factor = reduced_costs[column];
+    for (int col = 0; col < num_columns; ++col) {
+        reduced_costs[col] -= factor * pivot_row[col];
+    }
+    reduced_costs[column] = -factor * inverse;
+    swap(row_variables[row], column_variables[column]);
+}
+
+double LandmarkCombinatorialOptimalSharedCostAssignment::maximize(
+    int num_rows, int num_columns) {
+    const double epsilon = 1e-9;
+    /*
+      We choose the entering variable with the largest reduced cost. After
+      this many degenerate pivots in a row, we switch to Bland's rule to
+      avoid cycling.
+    */
+    const int max_degenerate_pivots = 50;
+    double value = 0;
+    int num_degenerate_pivots = 0;
+    while (true) {
+        bool use_blands_rule = num_degenerate_pivots >= max_degenerate_pivots;
+        int column = -1;
+        for (int col = 0; col < num_columns; ++col) {
+            if (reduced_costs[col] > epsilon &&
+                (column == -1 ||
+                 (use_blands_rule
+                  ? column_variables[col] < column_variables[column]
+                  : reduced_costs[col] > reduced_costs[column]))) {
+                column = col;
+            }
+        }
+        if (column == -1) {
+            return value;
+        }
+        int row = -1;
+        double min_ratio = numeric_limits<double>::infinity();
+        for (int r = 0; r < num_rows; ++r) {
+            double entry = tableau[r * num_columns + column];
+            if (entry <= epsilon) {
+                continue;
+            }
+            double ratio = max(rhs[r], 0.0) / entry;
+            if (row == -1 || ratio < min_ratio - epsilon ||
+                (ratio <= min_ratio + epsilon &&
+                 (use_blands_rule
+                  ? row_variables[r] < row_variables[row]
+                  : entry > tableau[row * num_columns + column]))) {
+                row = r;
+                min_ratio = min(min_ratio, ratio);
+            }
+        }
+        // The LP is bounded because every landmark has an achiever.
+        assert(row != -1);
+        if (min_ratio <= epsilon) {
+            ++num_degenerate_pivots;
+        } else {
+            num_degenerate_pivots = 0;
+        }
+        value += reduced_costs[column] * max(rhs[row], 0.0) /
+            tableau[row * num_columns + column];
+        pivot(num_rows, num_columns, row, column);
+    }
+}
+
+double LandmarkCombinatorialOptimalSharedCostAssignment::solve_component(
+    const vector<int> &landmarks, const vector<int> &operators) {
+    /*
+      Set up the tableau with one row per operator and one column per
+      landmark. Variables 0 to num_columns - 1 are the landmark variables,
+      the others are the slack variables of the operator constraints.
+    */
+    int num_rows = operators.size();
+    int num_columns = landmarks.size();
+    for (int col = 0; col < num_columns; ++col) {
+        landmark_columns[landmarks[col]] = col;
+    }
+    tableau.assign(num_rows * num_columns, 0.0);
+    rhs.resize(num_rows);
+    row_variables.resize(num_rows);
+    for (int row = 0; row < num_rows; ++row) {
+        int op_id = operators[row];
+        for (int lm : operator_landmarks[op_id]) {
+            tableau[row * num_columns + landmark_columns[lm]] = 1.0;
+        }
+        rhs[row] = operator_costs[op_id];
+        row_variables[row] = num_columns + row;
+    }
+    reduced_costs.assign(num_columns, 1.0);
+    column_variables.resize(num_columns);
+    for (int col = 0; col < num_columns; ++col) {
+        column_variables[col] = col;
+    }
+    return maximize(num_rows, num_columns);
+}
+
+double LandmarkCombinatorialOptimalSharedCostAssignment::cost_sharing_h_value(
+    const LandmarkStatusManager &lm_status_manager,
+    const State &ancestor_state) {
+    ConstBitsetView past =
+        lm_status_manager.get_past_landmarks(ancestor_state);
+    ConstBitsetView future =
+        lm_status_manager.get_future_landmarks(ancestor_state);
+
+    num_landmarks = 0;
+    for (int lm_id = 0; lm_id < lm_graph.get_num_landmarks(); ++lm_id) {
+        if (future.test(lm_id)) {
+            const set<int> &achievers = get_achievers(
+                lm_graph.get_node(lm_id)->get_landmark(), past.test(lm_id));
+            if (achievers.empty())
+                return numeric_limits<double>::max();
+            if (num_landmarks == static_cast<int>(landmark_achievers.size())) {
+                landmark_achievers.emplace_back();
+            }
+            landmark_achievers[num_landmarks++].assign(
+                achievers.begin(), achievers.end());
+        }
+    }
+    landmark_is_removed.assign(num_landmarks, false);
+
+    collect_operator_landmarks();
+    while (true) {
+        if (remove_dominated_landmarks()) {
+            collect_operator_landmarks();
+        }
+        if (!remove_dominated_operators()) {
+            break;
+        }
+        collect_operator_landmarks();
+    }
+
+    // Sum up the optimal values of the connected components.
+    double h = 0;
+    landmark_components.assign(num_landmarks, -1);
+    landmark_columns.resize(num_landmarks);
+    vector<int> component_landmarks;
+    vector<int> component_operators;
+    int num_components = 0;
+    for (int start = 0; start < num_landmarks; ++start) {
+        if (landmark_is_removed[start] || landmark_components[start] != -1) {
+            continue;
+        }
+        component_landmarks.assign(1, start);
+        component_operators.clear();
+        landmark_components[start] = num_components;
+        for (size_t i = 0; i < component_landmarks.size(); ++i) {
+            for (int op_id : landmark_achievers[component_landmarks[i]]) {
+                if (operator_components[op_id] == num_components) {
+                    continue;
+                }
+                operator_components[op_id] = num_components;
+                component_operators.push_back(op_id);
+                for (int lm : operator_landmarks[op_id]) {
+                    if (landmark_components[lm] == -1) {
+                        landmark_components[lm] = num_components;
+                        component_landmarks.push_back(lm);
+                    }
+                }
+            }
+        }
+        ++num_components;
+        if (component_landmarks.size() == 1) {
+            // The cheapest achiever dominates all others.
+            assert(component_operators.size() == 1);
+            h += operator_costs[component_operators[0]];
+        } else {
+            h += solve_component(component_landmarks, component_operators);
+        }
+    }
+    for (int op_id : relevant_operators) {
+        operator_components[op_id] = -1;
+    }
+    return h;
+}
 }
@@ -68,6 +68,64 @@ public:
         const LandmarkStatusManager &lm_status_manager,
         const State &ancestor_state) override;
 };
+
+/*
+  Computes the same optimal cost partitioning as
+  LandmarkEfficientOptimalSharedCostAssignment without an LP solver. We
+  consider the dual LP
+
+    min sum_o cost(o) * y_o  s.t.  sum_{o achieves l} y_o >= 1 for all l
+
+  and shrink it by removing landmarks whose achievers are a superset of the
+  achievers of another landmark and operators that achieve a subset of the
+  landmarks of a cheaper operator. Both removals do not change the optimal
+  value. The remaining problem is split into connected components, i.e.,
+  sets of landmarks connected via shared achievers. Components with a
+  single landmark have the value of its cheapest achiever. We solve the
+  remaining components with the primal simplex method on a dense tableau.
+  Since all constraints are of the form sum_{l in L} x_l <= cost(o) with
+  cost(o) >= 0, the initial slack basis is feasible and no phase 1 is
+  necessary.
+*/
+class LandmarkCombinatorialOptimalSharedCostAssignment : public LandmarkCostAssignment {
+    /*
+      Achievers of the future landmarks of the current state. We only use
+      the first num_landmarks entries to reuse the allocated memory.
+    */
+    std::vector<std::vector<int>> landmark_achievers;
+    int num_landmarks;
+    std::vector<bool> landmark_is_removed;
+    // Landmarks achieved by each operator that is still considered.
+    std::vector<std::vector<int>> operator_landmarks;
+    std::vector<int> relevant_operators;
+    std::vector<bool> operator_is_removed;
+    std::vector<int> landmark_components;
+    std::vector<int> operator_components;
+    std::vector<int> landmark_columns;
+
+    // Scratch space for the simplex method.
+    std::vector<double> tableau;
+    std::vector<double> rhs;
+    std::vector<double> reduced_costs;
+    std::vector<int> row_variables;
+    std::vector<int> column_variables;
+
+    void collect_operator_landmarks();
+    bool remove_dominated_landmarks();
+    bool remove_dominated_operators();
+    double solve_component(
+        const std::vector<int> &landmarks, const std::vector<int> &operators);
+    void pivot(int num_rows, int num_columns, int row, int column);
+    double maximize(int num_rows, int num_columns);
+public:
+    LandmarkCombinatorialOptimalSharedCostAssignment(
+        const std::vector<int> &operator_costs,
+        const LandmarkGraph &graph);
+
+    virtual double cost_sharing_h_value(
+        const LandmarkStatusManager &lm_status_manager,
+        const State &ancestor_state) override;
+};
 }
 
 #endif
@@ -47,10 +47,19 @@ void LandmarkCostPartitioningHeuristic::check_unsupported_features(
 void LandmarkCostPartitioningHeuristic::set_cost_assignment(
     const plugins::Options &opts) {
     if (opts.get<bool>("optimal")) {
-        lm_cost_assignment =
-            utils::make_unique_ptr<LandmarkEfficientOptimalSharedCostAssignment>(
-                task_properties::get_operator_costs(task_proxy),
-                *lm_graph, opts.get<lp::LPSolverType>("lpsolver"));
+        OptimalCostPartitioningSolver solver =
+            opts.get<OptimalCostPartitioningSolver>("optimal_solver");
+        if (solver == OptimalCostPartitioningSolver::LP) {
+            lm_cost_assignment =
+                utils::make_unique_ptr<LandmarkEfficientOptimalSharedCostAssignment>(
+                    task_properties::get_operator_costs(task_proxy),
+                    *lm_graph, opts.get<lp::LPSolverType>("lpsolver"));
+        } else {
+            lm_cost_assignment =
+                utils::make_unique_ptr<LandmarkCombinatorialOptimalSharedCostAssignment>(
+                    task_properties::get_operator_costs(task_proxy),
+                    *lm_graph);
+        }
     } else {
         lm_cost_assignment =
             utils::make_unique_ptr<LandmarkUniformSharedCostAssignment>(
@@ -108,6 +117,10 @@ public:
             "optimal",
             "use optimal (LP-based) cost sharing",
             "false");
+        add_option<OptimalCostPartitioningSolver>(
+            "optimal_solver",
+            "how to solve the LP for optimal cost sharing",
+            "lp");
         add_option<bool>("alm", "use action landmarks", "true");
         lp::add_lp_solver_option_to_feature(*this);
 
@@ -127,8 +140,10 @@ public:
             "which point the above inequality might not hold anymore.");
         document_note(
             "Optimal Cost Partitioning",
-            "To use ``optimal=true``, you must build the planner with LP "
-            "support. See LPBuildInstructions.");
+            "To use ``optimal=true`` with ``optimal_solver=lp``, you must "
+            "build the planner with LP support (or use ``lpsolver=builtin``). "
+            "See LPBuildInstructions. Both solvers compute the same "
+            "heuristic values.");
         document_note(
             "Preferred operators",
             "Preferred operators should not be used for optimal planning. "
@@ -151,4 +166,13 @@ public:
 };
 
 static plugins::FeaturePlugin<LandmarkCostPartitioningHeuristicFeature> _plugin;
+
+static plugins::TypedEnumPlugin<OptimalCostPartitioningSolver> _enum_plugin({
+        {"lp",
+         "solve the LP with the LP solver given by the lpsolver option"},
+        {"combinatorial",
+         "shrink the LP by removing dominated landmarks and operators, "
+         "split it into independent components and solve those with a "
+         "specialized simplex method; needs no LP solver"}
+    });
 }
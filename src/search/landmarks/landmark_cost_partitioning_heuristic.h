@@ -6,6 +6,11 @@
 namespace landmarks {
 class LandmarkCostAssignment;
 
+enum class OptimalCostPartitioningSolver {
+    LP,
+    COMBINATORIAL
+};
+
 class LandmarkCostPartitioningHeuristic : public LandmarkHeuristic {
     std::unique_ptr<LandmarkCostAssignment> lm_cost_assignment;
 
@@ -13,6 +13,7 @@
 
 #include <fstream>
 #include <limits>
+#include <mutex>
 
 using namespace std;
 
@@ -34,6 +35,10 @@ LandmarkFactory::LandmarkFactory(const plugins::Options &opts)
   If you want to compute different landmark graphs for different
   Exploration objects, you have to use separate landmark factories.
 
+  The same factory can be used concurrently, e.g., several times within a
+  merged landmark factory that computes its components in parallel.
+  Therefore, the graph is computed under a lock.
+
   This solution remains temporary as long as the question of when and
   how to reuse landmark graphs is open.
 
@@ -44,6 +49,7 @@ LandmarkFactory::LandmarkFactory(const plugins::Options &opts)
 */
 shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
     const shared_ptr<AbstractTask> &task) {
+    lock_guard<mutex> lock(lm_graph_mutex);
     if (lm_graph) {
         if (lm_graph_task != task.get()) {
             cerr << "LandmarkFactory was asked to compute landmark graphs for "
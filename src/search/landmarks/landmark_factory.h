@@ -8,6 +8,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -65,6 +66,7 @@ protected:
 
 private:
     AbstractTask *lm_graph_task;
+    std::mutex lm_graph_mutex;
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task) = 0;
 
@@ -9,96 +9,87 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 using namespace std;
 using utils::ExitCode;
 
 namespace landmarks {
+// The following functions operate on sorted vectors without duplicates.
+
 // alist = alist \cup other
 template<typename T>
-void union_with(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin();
-    typename list<T>::const_iterator it2 = other.begin();
-
-    while ((it1 != alist.end()) && (it2 != other.end())) {
-        if (*it1 < *it2) {
-            ++it1;
-        } else if (*it1 > *it2) {
-            alist.insert(it1, *it2);
-            ++it2;
-        } else {
-            ++it1;
-            ++it2;
-        }
+void union_with(vector<T> &alist, const vector<T> &other) {
+    if (other.empty()) {
+        return;
+    }
+    // Build the union in a buffer to keep the capacity of alist tight.
+    thread_local vector<T> result;
+    result.clear();
+    set_union(alist.begin(), alist.end(), other.begin(), other.end(),
+              back_inserter(result));
+    if (result.size() != alist.size()) {
+        alist.assign(result.begin(), result.end());
     }
-    alist.insert(it1, it2, other.end());
 }
 
 // alist = alist \cap other
 template<typename T>
-void intersect_with(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin(), tmp;
-    typename list<T>::const_iterator it2 = other.begin();
+void intersect_with(vector<T> &alist, const vector<T> &other) {
+    typename vector<T>::iterator it1 = alist.begin(), out = alist.begin();
+    typename vector<T>::const_iterator it2 = other.begin();
 
     while ((it1 != alist.end()) && (it2 != other.end())) {
         if (*it1 < *it2) {
-            tmp = it1;
-            ++tmp;
-            alist.erase(it1);
-            it1 = tmp;
+            ++it1;
         } else if (*it1 > *it2) {
             ++it2;
         } else {
+            *out++ = *it1;
             ++it1;
             ++it2;
         }
     }
-    alist.erase(it1, alist.end());
+    alist.erase(out, alist.end());
 }
 
 // alist = alist \setminus other
 template<typename T>
-void set_minus(list<T> &alist, const list<T> &other) {
-    typename list<T>::iterator it1 = alist.begin(), tmp;
-    typename list<T>::const_iterator it2 = other.begin();
+void set_minus(vector<T> &alist, const vector<T> &other) {
+    typename vector<T>::iterator it1 = alist.begin(), out = alist.begin();
+    typename vector<T>::const_iterator it2 = other.begin();
 
-    while ((it1 != alist.end()) && (it2 != other.end())) {
-        if (*it1 < *it2) {
+    while (it1 != alist.end()) {
+        if (it2 == other.end() || *it1 < *it2) {
+            *out++ = *it1;
             ++it1;
         } else if (*it1 > *it2) {
             ++it2;
         } else {
-            tmp = it1;
-            ++tmp;
-            alist.erase(it1);
-            it1 = tmp;
+            ++it1;
             ++it2;
         }
     }
+    alist.erase(out, alist.end());
 }
 
 // alist = alist \cup {val}
 template<typename T>
-void insert_into(list<T> &alist, const T &val) {
-    typename list<T>::iterator it1 = alist.begin();
-
-    while (it1 != alist.end()) {
-        if (*it1 > val) {
-            alist.insert(it1, val);
-            return;
-        } else if (*it1 < val) {
-            ++it1;
-        } else {
-            return;
-        }
+void insert_into(vector<T> &alist, const T &val) {
+    typename vector<T>::iterator it = lower_bound(alist.begin(), alist.end(), val);
+    if (it == alist.end() || *it != val) {
+        alist.insert(it, val);
     }
-    alist.insert(it1, val);
 }
 
 template<typename T>
-static bool contains(list<T> &alist, const T &val) {
-    return find(alist.begin(), alist.end(), val) != alist.end();
+static bool contains(const vector<T> &alist, const T &val) {
+    return binary_search(alist.begin(), alist.end(), val);
 }
 
 
@@ -347,13 +338,14 @@ void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, const PMOp
                 effs.insert(fluent);
             }
         }
-        for (size_t i = 0; i < op.cond_noops.size(); ++i) {
+        for (int i = 0; i < op.get_num_cond_noops(); ++i) {
             cond_pc.clear();
             cond_eff.clear();
             int pm_fluent;
-            size_t j;
+            int j;
             log << "PC:" << endl;
-            for (j = 0; (pm_fluent = op.cond_noops[i][j]) != -1; ++j) {
+            for (j = op.cond_noop_starts[i];
+                 (pm_fluent = op.cond_noop_fluents[j]) != -1; ++j) {
                 print_fluentset(variables, h_m_table_[pm_fluent].fluents);
                 log << endl;
 
@@ -366,8 +358,8 @@ void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, const PMOp
             ++j;
 
             log << "EFF:" << endl;
-            for (; j < op.cond_noops[i].size(); ++j) {
-                int pm_fluent = op.cond_noops[i][j];
+            for (; j < op.cond_noop_starts[i + 1]; ++j) {
+                int pm_fluent = op.cond_noop_fluents[j];
 
                 print_fluentset(variables, h_m_table_[pm_fluent].fluents);
                 log << endl;
@@ -456,7 +448,6 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
     FluentSet pc, eff;
     vector<FluentSet> pc_subsets, eff_subsets, noop_pc_subsets, noop_eff_subsets;
 
-    static int op_count = 0;
     int set_index, noop_index;
 
     OperatorsProxy operators = task_proxy.get_operators();
@@ -471,7 +462,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
     // represent noops as "conditional" effects
     for (OperatorProxy op : operators) {
         PMOp &pm_op = pm_ops_[op.get_id()];
-        pm_op.index = op_count++;
+        pm_op.index = op.get_id();
 
         pc_subsets.clear();
         eff_subsets.clear();
@@ -488,7 +479,6 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
             assert(set_indices_.find(pc_subset) != set_indices_.end());
             set_index = set_indices_[pc_subset];
             pm_op.pc.push_back(set_index);
-            h_m_table_[set_index].pc_for.emplace_back(op.get_id(), -1);
         }
 
         // same for effects
@@ -508,14 +498,11 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         // they conflict with the effect of the operator (no need to check pc
         // because mvvs appearing in pc also appear in effect
 
-        FluentSetToIntMap::const_iterator it = set_indices_.begin();
-        while (static_cast<int>(it->first.size()) < m_
-               && it != set_indices_.end()) {
-            if (possible_noop_set(variables, eff, it->first)) {
+        for (int small_set_index : small_set_indices_) {
+            const FluentSet &small_set = h_m_table_[small_set_index].fluents;
+            if (possible_noop_set(variables, eff, small_set)) {
                 // for each such set, add a "conditional effect" to the operator
-                pm_op.cond_noops.resize(pm_op.cond_noops.size() + 1);
-
-                vector<int> &this_cond_noop = pm_op.cond_noops.back();
+                vector<int> &this_cond_noop = pm_op.cond_noop_fluents;
 
                 noop_pc_subsets.clear();
                 noop_eff_subsets.clear();
@@ -523,10 +510,8 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // get the subsets that have >= 1 element in the pc (unless pc is empty)
                 // and >= 1 element in the other set
 
-                get_split_m_sets(variables, m_, noop_pc_subsets, pc, it->first);
-                get_split_m_sets(variables, m_, noop_eff_subsets, eff, it->first);
-
-                this_cond_noop.reserve(noop_pc_subsets.size() + noop_eff_subsets.size() + 1);
+                get_split_m_sets(variables, m_, noop_pc_subsets, pc, small_set);
+                get_split_m_sets(variables, m_, noop_eff_subsets, eff, small_set);
 
                 unsat_pc_count_[op.get_id()].second.push_back(noop_pc_subsets.size());
 
@@ -536,9 +521,8 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                     assert(set_indices_.find(noop_pc_subsets[j]) != set_indices_.end());
 
                     set_index = set_indices_[noop_pc_subsets[j]];
-                    this_cond_noop.push_back(set_index);
                     // these facts are "conditional pcs" for this action
-                    h_m_table_[set_index].pc_for.emplace_back(op.get_id(), noop_index);
+                    this_cond_noop.push_back(set_index);
                 }
 
                 // separator
@@ -552,13 +536,50 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                     set_index = set_indices_[noop_eff_subsets[j]];
                     this_cond_noop.push_back(set_index);
                 }
+                pm_op.cond_noop_starts.push_back(this_cond_noop.size());
 
                 ++noop_index;
             }
-            ++it;
         }
         print_pm_op(variables, pm_op);
     }
+
+    build_pc_for();
+}
+
+/*
+  Collect the operators and noops each P_m fluent is a pc for. We count
+  the entries of each fluent first and then fill the flat array, so no
+  intermediate copy of the entries is needed.
+*/
+void LandmarkFactoryHM::build_pc_for() {
+    auto for_each_pc = [this](const function<void(int, const FactPair &)> &callback) {
+            for (size_t op_id = 0; op_id < pm_ops_.size(); ++op_id) {
+                const PMOp &pm_op = pm_ops_[op_id];
+                for (int pc : pm_op.pc) {
+                    callback(pc, FactPair(op_id, -1));
+                }
+                for (int noop = 0; noop < pm_op.get_num_cond_noops(); ++noop) {
+                    for (int i = pm_op.cond_noop_starts[noop];
+                         pm_op.cond_noop_fluents[i] != -1; ++i) {
+                        callback(pm_op.cond_noop_fluents[i], FactPair(op_id, noop));
+                    }
+                }
+            }
+        };
+
+    pc_for_starts_.assign(h_m_table_.size() + 1, 0);
+    for_each_pc([this](int pm_fluent, const FactPair &) {
+                    ++pc_for_starts_[pm_fluent + 1];
+                });
+    for (size_t i = 1; i < pc_for_starts_.size(); ++i) {
+        pc_for_starts_[i] += pc_for_starts_[i - 1];
+    }
+    pc_for_.resize(pc_for_starts_.back(), FactPair::no_fact);
+    vector<int> next_position(pc_for_starts_.begin(), pc_for_starts_.end() - 1);
+    for_each_pc([this, &next_position](int pm_fluent, const FactPair &info) {
+                    pc_for_[next_position[pm_fluent]++] = info;
+                });
 }
 
 bool LandmarkFactoryHM::interesting(const VariablesProxy &variables,
@@ -572,7 +593,8 @@ LandmarkFactoryHM::LandmarkFactoryHM(const plugins::Options &opts)
     : LandmarkFactory(opts),
       m_(opts.get<int>("m")),
       conjunctive_landmarks(opts.get<bool>("conjunctive_landmarks")),
-      use_orders(opts.get<bool>("use_orders")) {
+      use_orders(opts.get<bool>("use_orders")),
+      num_threads(opts.get<int>("threads")) {
 }
 
 void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
@@ -588,16 +610,33 @@ void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
     get_m_sets(task_proxy.get_variables(), m_, msets);
 
     // map each set to an integer
+    h_m_table_.resize(msets.size());
+    set_indices_.reserve(msets.size());
     for (size_t i = 0; i < msets.size(); ++i) {
-        h_m_table_.emplace_back();
         set_indices_[msets[i]] = i;
-        h_m_table_[i].fluents = msets[i];
+        if (static_cast<int>(msets[i].size()) < m_) {
+            small_set_indices_.push_back(i);
+        }
+        h_m_table_[i].fluents = move(msets[i]);
     }
+    sort(small_set_indices_.begin(), small_set_indices_.end(),
+         [this](int set1, int set2) {
+             return FluentSetComparer()(
+                 h_m_table_[set1].fluents, h_m_table_[set2].fluents);
+         });
     if (log.is_at_least_normal()) {
         log << "Using " << h_m_table_.size() << " P^m fluents." << endl;
     }
 
     build_pm_ops(task_proxy);
+    if (log.is_at_least_normal()) {
+        int num_cond_noops = 0;
+        for (const PMOp &pm_op : pm_ops_) {
+            num_cond_noops += pm_op.get_num_cond_noops();
+        }
+        log << "Using " << pm_ops_.size() << " P^m operators with "
+            << num_cond_noops << " conditional noops." << endl;
+    }
 }
 
 void LandmarkFactoryHM::postprocess(const TaskProxy &task_proxy) {
@@ -688,6 +727,9 @@ void LandmarkFactoryHM::free_unneeded_memory() {
     utils::release_vector_memory(h_m_table_);
     utils::release_vector_memory(pm_ops_);
     utils::release_vector_memory(unsat_pc_count_);
+    utils::release_vector_memory(small_set_indices_);
+    utils::release_vector_memory(pc_for_starts_);
+    utils::release_vector_memory(pc_for_);
 
     set_indices_.clear();
     lm_node_table_.clear();
@@ -699,7 +741,8 @@ void LandmarkFactoryHM::free_unneeded_memory() {
 void LandmarkFactoryHM::propagate_pm_fact(int factindex, bool newly_discovered,
                                           TriggerSet &trigger) {
     // for each action/noop for which fact is a pc
-    for (const FactPair &info : h_m_table_[factindex].pc_for) {
+    for (int i = pc_for_starts_[factindex]; i < pc_for_starts_[factindex + 1]; ++i) {
+        const FactPair &info = pc_for_[i];
         // a pc for the action itself
         if (info.value == -1) {
             if (newly_discovered) {
@@ -723,13 +766,26 @@ void LandmarkFactoryHM::propagate_pm_fact(int factindex, bool newly_discovered,
                 // if not already triggering all noops, add this one
                 if ((trigger.find(info.var) == trigger.end()) ||
                     (!trigger[info.var].empty())) {
-                    trigger[info.var].insert(info.value);
+                    trigger[info.var].push_back(info.value);
                 }
             }
         }
     }
 }
 
+/*
+  The fixpoint is computed level by level. The operators and noops triggered
+  in a level are applied in batches. For each batch, we first compute the
+  landmarks of all operators and noops from the landmarks of their
+  preconditions. Then we update the landmarks of all their effects, where
+  each P_m fluent is updated by a single job, and finally trigger the
+  operators and noops for the next level. Both steps only read data of
+  previous batches or write to separate locations, so they can run in
+  parallel. The batches limit the memory needed for the intermediate
+  landmark sets. The landmarks of each fluent are the greatest fixpoint of
+  the update rules, so the result doesn't depend on the order in which the
+  updates are applied.
+*/
 void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
     // get subsets of initial state
     vector<FluentSet> init_subsets;
@@ -754,92 +810,23 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
         }
     }
 
-    vector<int>::iterator it;
-    TriggerSet::iterator op_it;
-
-    list<int> local_landmarks;
-    list<int> local_necessary;
-
-    size_t prev_size;
+    const int max_landmark_sets_per_batch = 1024;
 
     int level = 1;
 
     // while we have actions to apply
     while (!current_trigger.empty()) {
-        for (op_it = current_trigger.begin(); op_it != current_trigger.end(); ++op_it) {
-            local_landmarks.clear();
-            local_necessary.clear();
-
-            int op_index = op_it->first;
-            PMOp &action = pm_ops_[op_index];
-
-            // gather landmarks for pcs
-            // in the set of landmarks for each fact, the fact itself is not stored
-            // (only landmarks preceding it)
-            for (it = action.pc.begin(); it != action.pc.end(); ++it) {
-                union_with(local_landmarks, h_m_table_[*it].landmarks);
-                insert_into(local_landmarks, *it);
-
-                if (use_orders) {
-                    insert_into(local_necessary, *it);
-                }
-            }
-
-            for (it = action.eff.begin(); it != action.eff.end(); ++it) {
-                if (h_m_table_[*it].level != -1) {
-                    prev_size = h_m_table_[*it].landmarks.size();
-                    intersect_with(h_m_table_[*it].landmarks, local_landmarks);
-
-                    // if the add effect appears in local landmarks,
-                    // fact is being achieved for >1st time
-                    // no need to intersect for gn orderings
-                    // or add op to first achievers
-                    if (!contains(local_landmarks, *it)) {
-                        insert_into(h_m_table_[*it].first_achievers, op_index);
-                        if (use_orders) {
-                            intersect_with(h_m_table_[*it].necessary, local_necessary);
-                        }
-                    }
-
-                    if (h_m_table_[*it].landmarks.size() != prev_size)
-                        propagate_pm_fact(*it, false, next_trigger);
-                } else {
-                    h_m_table_[*it].level = level;
-                    h_m_table_[*it].landmarks = local_landmarks;
-                    if (use_orders) {
-                        h_m_table_[*it].necessary = local_necessary;
-                    }
-                    insert_into(h_m_table_[*it].first_achievers, op_index);
-                    propagate_pm_fact(*it, true, next_trigger);
-                }
-            }
-
-            // landmarks changed for action itself, have to recompute
-            // landmarks for all noop effects
-            if (op_it->second.empty()) {
-                for (size_t i = 0; i < action.cond_noops.size(); ++i) {
-                    // actions pcs are satisfied, but cond. effects may still have
-                    // unsatisfied pcs
-                    if (unsat_pc_count_[op_index].second[i] == 0) {
-                        compute_noop_landmarks(op_index, i,
-                                               local_landmarks,
-                                               local_necessary,
-                                               level, next_trigger);
-                    }
-                }
-            }
-            // only recompute landmarks for conditions whose
-            // landmarks have changed
-            else {
-                for (set<int>::iterator noop_it = op_it->second.begin();
-                     noop_it != op_it->second.end(); ++noop_it) {
-                    assert(unsat_pc_count_[op_index].second[*noop_it] == 0);
-
-                    compute_noop_landmarks(op_index, *noop_it,
-                                           local_landmarks,
-                                           local_necessary,
-                                           level, next_trigger);
-                }
+        vector<PMApplication> applications = get_applications(current_trigger);
+        vector<PMApplication> batch;
+        int num_landmark_sets = 0;
+        for (size_t i = 0; i < applications.size(); ++i) {
+            num_landmark_sets += applications[i].noops.size() + 1;
+            batch.push_back(move(applications[i]));
+            if (num_landmark_sets >= max_landmark_sets_per_batch
+                || i == applications.size() - 1) {
+                apply_batch(batch, level, next_trigger);
+                batch.clear();
+                num_landmark_sets = 0;
             }
         }
         current_trigger.swap(next_trigger);
@@ -855,70 +842,174 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
     }
 }
 
-void LandmarkFactoryHM::compute_noop_landmarks(
-    int op_index, int noop_index,
-    list<int> const &local_landmarks,
-    list<int> const &local_necessary,
-    int level,
-    TriggerSet &next_trigger) {
-    list<int> cn_necessary, cn_landmarks;
-    size_t prev_size;
-    int pm_fluent;
-
-    PMOp &action = pm_ops_[op_index];
-    vector<int> &pc_eff_pair = action.cond_noops[noop_index];
-
-    cn_landmarks.clear();
-
-    cn_landmarks = local_landmarks;
+void LandmarkFactoryHM::apply_batch(
+    vector<PMApplication> &batch, int level, TriggerSet &next_trigger) {
+    utils::parallel_for(num_threads, batch.size(), [&](int i) {
+            compute_application_landmarks(batch[i]);
+        });
+
+    vector<FluentUpdate> updates;
+    for (const PMApplication &application : batch) {
+        int op_index = application.op_index;
+        const PMOp &action = pm_ops_[op_index];
+        for (int eff : action.eff) {
+            updates.push_back({eff, op_index, &application.landmarks[0],
+                               &application.necessary[0]});
+        }
+        for (size_t i = 0; i < application.noops.size(); ++i) {
+            int noop = application.noops[i];
+            auto begin = action.cond_noop_fluents.begin() + action.cond_noop_starts[noop];
+            auto end = action.cond_noop_fluents.begin() + action.cond_noop_starts[noop + 1];
+            // skip the preconditions and the separator
+            auto it = find(begin, end, -1);
+            for (++it; it != end; ++it) {
+                updates.push_back({*it, op_index, &application.landmarks[i + 1],
+                                   &application.necessary[i + 1]});
+            }
+        }
+    }
+    // group the updates by fluent, keeping the order of the applications
+    stable_sort(updates.begin(), updates.end(),
+                [](const FluentUpdate &u1, const FluentUpdate &u2) {
+                    return u1.fluent < u2.fluent;
+                });
+    vector<int> group_starts;
+    for (size_t i = 0; i < updates.size(); ++i) {
+        if (i == 0 || updates[i].fluent != updates[i - 1].fluent) {
+            group_starts.push_back(i);
+        }
+    }
+    group_starts.push_back(updates.size());
+
+    int num_groups = group_starts.size() - 1;
+    vector<FluentChange> changes(num_groups);
+    utils::parallel_for(num_threads, num_groups, [&](int i) {
+            changes[i] = update_fluent(
+                updates, group_starts[i], group_starts[i + 1], level);
+        });
+
+    for (int i = 0; i < num_groups; ++i) {
+        if (changes[i] != FluentChange::NONE) {
+            propagate_pm_fact(updates[group_starts[i]].fluent,
+                              changes[i] == FluentChange::NEWLY_REACHED,
+                              next_trigger);
+        }
+    }
+}
 
-    if (use_orders) {
-        cn_necessary.clear();
-        cn_necessary = local_necessary;
+vector<LandmarkFactoryHM::PMApplication> LandmarkFactoryHM::get_applications(
+    const TriggerSet &trigger) const {
+    vector<PMApplication> applications;
+    applications.reserve(trigger.size());
+    for (const auto &[op_index, triggered_noops] : trigger) {
+        PMApplication application;
+        application.op_index = op_index;
+        if (triggered_noops.empty()) {
+            // landmarks changed for action itself, have to recompute
+            // landmarks for all noop effects
+            const vector<int> &unsat_noop_pcs = unsat_pc_count_[op_index].second;
+            for (size_t i = 0; i < unsat_noop_pcs.size(); ++i) {
+                // actions pcs are satisfied, but cond. effects may still have
+                // unsatisfied pcs
+                if (unsat_noop_pcs[i] == 0) {
+                    application.noops.push_back(i);
+                }
+            }
+        } else {
+            // only recompute landmarks for conditions whose
+            // landmarks have changed
+            application.noops = triggered_noops;
+            utils::sort_unique(application.noops);
+        }
+        applications.push_back(move(application));
     }
+    sort(applications.begin(), applications.end(),
+         [](const PMApplication &app1, const PMApplication &app2) {
+             return app1.op_index < app2.op_index;
+         });
+    return applications;
+}
 
-    size_t i;
-    for (i = 0; (pm_fluent = pc_eff_pair[i]) != -1; ++i) {
-        union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks);
-        insert_into(cn_landmarks, pm_fluent);
+void LandmarkFactoryHM::compute_application_landmarks(
+    PMApplication &application) const {
+    const PMOp &action = pm_ops_[application.op_index];
+    int num_effects = application.noops.size() + 1;
+    application.landmarks.resize(num_effects);
+    application.necessary.resize(num_effects);
+
+    // gather landmarks for pcs
+    // in the set of landmarks for each fact, the fact itself is not stored
+    // (only landmarks preceding it)
+    vector<int> &local_landmarks = application.landmarks[0];
+    vector<int> &local_necessary = application.necessary[0];
+    for (int pc : action.pc) {
+        union_with(local_landmarks, h_m_table_[pc].landmarks);
+        insert_into(local_landmarks, pc);
 
         if (use_orders) {
-            insert_into(cn_necessary, pm_fluent);
+            insert_into(local_necessary, pc);
         }
     }
 
-    // go to the beginning of the effects section
-    ++i;
+    for (size_t i = 0; i < application.noops.size(); ++i) {
+        vector<int> &cn_landmarks = application.landmarks[i + 1];
+        vector<int> &cn_necessary = application.necessary[i + 1];
+        cn_landmarks = local_landmarks;
+        if (use_orders) {
+            cn_necessary = local_necessary;
+        }
+
+        int noop = application.noops[i];
+        for (int j = action.cond_noop_starts[noop];
+             action.cond_noop_fluents[j] != -1; ++j) {
+            int pm_fluent = action.cond_noop_fluents[j];
+            union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks);
+            insert_into(cn_landmarks, pm_fluent);
 
-    for (; i < pc_eff_pair.size(); ++i) {
-        pm_fluent = pc_eff_pair[i];
-        if (h_m_table_[pm_fluent].level != -1) {
-            prev_size = h_m_table_[pm_fluent].landmarks.size();
-            intersect_with(h_m_table_[pm_fluent].landmarks, cn_landmarks);
+            if (use_orders) {
+                insert_into(cn_necessary, pm_fluent);
+            }
+        }
+    }
+}
 
-            // if the add effect appears in cn_landmarks,
+LandmarkFactoryHM::FluentChange LandmarkFactoryHM::update_fluent(
+    const vector<FluentUpdate> &updates, int begin, int end, int level) {
+    int pm_fluent = updates[begin].fluent;
+    HMEntry &entry = h_m_table_[pm_fluent];
+    bool newly_reached = (entry.level == -1);
+    size_t prev_size = entry.landmarks.size();
+    for (int i = begin; i < end; ++i) {
+        const FluentUpdate &update = updates[i];
+        if (entry.level != -1) {
+            intersect_with(entry.landmarks, *update.landmarks);
+
+            // if the add effect appears in the landmarks of the application,
             // fact is being achieved for >1st time
             // no need to intersect for gn orderings
             // or add op to first achievers
-            if (!contains(cn_landmarks, pm_fluent)) {
-                insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
+            if (!contains(*update.landmarks, pm_fluent)) {
+                insert_into(entry.first_achievers, update.op_index);
                 if (use_orders) {
-                    intersect_with(h_m_table_[pm_fluent].necessary, cn_necessary);
+                    intersect_with(entry.necessary, *update.necessary);
                 }
             }
-
-            if (h_m_table_[pm_fluent].landmarks.size() != prev_size)
-                propagate_pm_fact(pm_fluent, false, next_trigger);
         } else {
-            h_m_table_[pm_fluent].level = level;
-            h_m_table_[pm_fluent].landmarks = cn_landmarks;
+            entry.level = level;
+            entry.landmarks = *update.landmarks;
             if (use_orders) {
-                h_m_table_[pm_fluent].necessary = cn_necessary;
+                entry.necessary = *update.necessary;
             }
-            insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
-            propagate_pm_fact(pm_fluent, true, next_trigger);
+            insert_into(entry.first_achievers, update.op_index);
         }
     }
+    if (newly_reached) {
+        return FluentChange::NEWLY_REACHED;
+    } else if (entry.landmarks.size() != prev_size) {
+        return FluentChange::LANDMARKS_CHANGED;
+    } else {
+        return FluentChange::NONE;
+    }
 }
 
 void LandmarkFactoryHM::add_lm_node(int set_index, bool goal) {
@@ -945,7 +1036,7 @@ void LandmarkFactoryHM::generate_landmarks(
     FluentSet goals = task_properties::get_fact_pairs(task_proxy.get_goals());
     VariablesProxy variables = task_proxy.get_variables();
     get_m_sets(variables, m_, goal_subsets, goals);
-    list<int> all_lms;
+    vector<int> all_lms;
     for (const FluentSet &goal_subset : goal_subsets) {
         assert(set_indices_.find(goal_subset) != set_indices_.end());
 
@@ -977,7 +1068,7 @@ void LandmarkFactoryHM::generate_landmarks(
         // do reduction of graph
         // if f2 is landmark for f1, subtract landmark set of f2 from that of f1
         for (int f1 : all_lms) {
-            list<int> everything_to_remove;
+            vector<int> everything_to_remove;
             for (int f2 : h_m_table_[f1].landmarks) {
                 union_with(everything_to_remove, h_m_table_[f2].landmarks);
             }
@@ -1032,6 +1123,12 @@ public:
             "conjunctive_landmarks",
             "keep conjunctive landmarks",
             "true");
+        add_option<int>(
+            "threads",
+            "Number of threads for computing the h^m landmarks. The result "
+            "is the same for all numbers of threads.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         add_landmark_factory_options_to_feature(*this);
         add_use_orders_option_to_feature(*this);
 
@@ -3,6 +3,8 @@
 
 #include "landmark_factory.h"
 
+#include "../utils/hash.h"
+
 namespace landmarks {
 using FluentSet = std::vector<FactPair>;
 
@@ -27,9 +29,22 @@ struct FluentSetComparer {
 struct PMOp {
     std::vector<int> pc;
     std::vector<int> eff;
-    // pc separated from effect by a value of -1
-    std::vector<std::vector<int>> cond_noops;
+    /*
+      Conditional noop i consists of the P_m fluents from
+      cond_noop_starts[i] to cond_noop_starts[i + 1] in cond_noop_fluents,
+      where the pc is separated from the effect by a value of -1.
+    */
+    std::vector<int> cond_noop_starts;
+    std::vector<int> cond_noop_fluents;
     int index;
+
+    PMOp()
+        : cond_noop_starts(1, 0) {
+    }
+
+    int get_num_cond_noops() const {
+        return cond_noop_starts.size() - 1;
+    }
 };
 
 // represents a fluent in the P_m problem
@@ -40,33 +55,59 @@ struct HMEntry {
     // 0 -> present in initial state
     int level;
 
-    std::list<int> landmarks;
-    std::list<int> necessary; // greedy necessary landmarks, disjoint from landmarks
-
-    std::list<int> first_achievers;
+    // sorted sets of P_m fluents
+    std::vector<int> landmarks;
+    std::vector<int> necessary; // greedy necessary landmarks, disjoint from landmarks
 
-    // first int = op index, second int conditional noop effect
-    // -1 for op itself
-    std::vector<FactPair> pc_for;
+    std::vector<int> first_achievers;
 
     HMEntry()
         : level(-1) {
     }
 };
 
-using FluentSetToIntMap = std::map<FluentSet, int, FluentSetComparer>;
+using FluentSetToIntMap = utils::HashMap<FluentSet, int>;
 
 class LandmarkFactoryHM : public LandmarkFactory {
-    using TriggerSet = std::unordered_map<int, std::set<int>>;
+    /*
+      Maps operators to the conditional noops (possibly with duplicates)
+      whose landmarks have to be recomputed. An empty vector means that all
+      noops of the operator are triggered.
+    */
+    using TriggerSet = std::unordered_map<int, std::vector<int>>;
+
+    // an operator of P_m and some of its conditional noops applied in one level
+    struct PMApplication {
+        int op_index;
+        std::vector<int> noops;
+        // entry 0 belongs to the operator, entry i + 1 to noops[i]
+        std::vector<std::vector<int>> landmarks;
+        std::vector<std::vector<int>> necessary;
+    };
+
+    // an effect of a PMApplication, i.e., a P_m fluent reached by it
+    struct FluentUpdate {
+        int fluent;
+        int op_index;
+        const std::vector<int> *landmarks;
+        const std::vector<int> *necessary;
+    };
+
+    enum class FluentChange {
+        NONE,
+        LANDMARKS_CHANGED,
+        NEWLY_REACHED
+    };
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task) override;
 
     void compute_h_m_landmarks(const TaskProxy &task_proxy);
-    void compute_noop_landmarks(int op_index, int noop_index,
-                                std::list<int> const &local_landmarks,
-                                std::list<int> const &local_necessary,
-                                int level,
-                                TriggerSet &next_trigger);
+    std::vector<PMApplication> get_applications(const TriggerSet &trigger) const;
+    void compute_application_landmarks(PMApplication &application) const;
+    void apply_batch(std::vector<PMApplication> &batch, int level,
+                     TriggerSet &next_trigger);
+    FluentChange update_fluent(const std::vector<FluentUpdate> &updates,
+                               int begin, int end, int level);
 
     void propagate_pm_fact(int factindex, bool newly_discovered,
                            TriggerSet &trigger);
@@ -75,6 +116,7 @@ class LandmarkFactoryHM : public LandmarkFactory {
                            const FluentSet &fs1,
                            const FluentSet &fs2);
     void build_pm_ops(const TaskProxy &task_proxy);
+    void build_pc_for();
     bool interesting(const VariablesProxy &variables,
                      const FactPair &fact1,
                      const FactPair &fact2) const;
@@ -96,6 +138,7 @@ class LandmarkFactoryHM : public LandmarkFactory {
     const int m_;
     const bool conjunctive_landmarks;
     const bool use_orders;
+    const int num_threads;
 
     std::map<int, LandmarkNode *> lm_node_table_;
 
@@ -103,6 +146,16 @@ class LandmarkFactoryHM : public LandmarkFactory {
     std::vector<PMOp> pm_ops_;
     // maps each <m set to an int
     FluentSetToIntMap set_indices_;
+    // sets of size < m, ordered by FluentSetComparer
+    std::vector<int> small_set_indices_;
+    /*
+      The operators and conditional noops that have P_m fluent i as pc are
+      stored from pc_for_starts_[i] to pc_for_starts_[i + 1] in pc_for_.
+      first int = op index, second int conditional noop effect
+      -1 for op itself
+    */
+    std::vector<int> pc_for_starts_;
+    std::vector<FactPair> pc_for_;
     // first is unsat pcs for operator
     // second is unsat pcs for conditional noops
     std::vector<std::pair<int, std::vector<int>>> unsat_pc_count_;
@@ -4,6 +4,7 @@
 #include "landmark_graph.h"
 
 #include "../plugins/plugin.h"
+#include "../utils/parallel.h"
 
 #include <set>
 
@@ -15,7 +16,8 @@ class LandmarkNode;
 
 LandmarkFactoryMerged::LandmarkFactoryMerged(const plugins::Options &opts)
     : LandmarkFactory(opts),
-      lm_factories(opts.get_list<shared_ptr<LandmarkFactory>>("lm_factories")) {
+      lm_factories(opts.get_list<shared_ptr<LandmarkFactory>>("lm_factories")),
+      num_threads(opts.get<int>("threads")) {
 }
 
 LandmarkNode *LandmarkFactoryMerged::get_matching_landmark(const Landmark &landmark) const {
@@ -44,11 +46,19 @@ void LandmarkFactoryMerged::generate_landmarks(
         log << "Merging " << lm_factories.size() << " landmark graphs" << endl;
     }
 
-    vector<shared_ptr<LandmarkGraph>> lm_graphs;
-    lm_graphs.reserve(lm_factories.size());
+    /*
+      Computing a landmark graph only reads the task, so we can compute
+      the graphs of all factories concurrently. The graphs are merged in
+      the given order afterwards, so the result doesn't depend on the
+      number of threads.
+    */
+    int num_factories = lm_factories.size();
+    vector<shared_ptr<LandmarkGraph>> lm_graphs(num_factories);
+    utils::parallel_for(num_threads, num_factories, [&](int i) {
+            lm_graphs[i] = lm_factories[i]->compute_lm_graph(task);
+        });
     achievers_calculated = true;
     for (const shared_ptr<LandmarkFactory> &lm_factory : lm_factories) {
-        lm_graphs.push_back(lm_factory->compute_lm_graph(task));
         achievers_calculated &= lm_factory->achievers_are_calculated();
     }
 
@@ -159,6 +169,13 @@ public:
             "Merges the landmarks and orderings from the parameter landmarks");
 
         add_list_option<shared_ptr<LandmarkFactory>>("lm_factories");
+        add_option<int>(
+            "threads",
+            "Number of threads for computing the landmark graphs of the "
+            "given factories. The graphs are merged one after the other, so "
+            "the result is the same for all numbers of threads.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         add_landmark_factory_options_to_feature(*this);
 
         document_note(
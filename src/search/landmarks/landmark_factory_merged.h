@@ -8,6 +8,7 @@
 namespace landmarks {
 class LandmarkFactoryMerged : public LandmarkFactory {
     std::vector<std::shared_ptr<LandmarkFactory>> lm_factories;
+    const int num_threads;
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task) override;
     void postprocess();
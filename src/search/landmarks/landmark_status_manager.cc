@@ -71,7 +71,38 @@ LandmarkStatusManager::LandmarkStatusManager(
       past_landmarks(vector<bool>(graph.get_num_landmarks(), true)),
       /* We initialize to false in *future_landmarks* because false is
          the neutral element for disjunction/set union. */
-      future_landmarks(vector<bool>(graph.get_num_landmarks(), false)) {
+      future_landmarks(vector<bool>(graph.get_num_landmarks(), false)),
+      parent_registry(nullptr),
+      parent_id(StateID::no_state) {
+    int num_blocks = BitsetMath::compute_num_blocks(graph.get_num_landmarks());
+    for (auto &node : graph.get_nodes()) {
+        const Landmark &lm = node->get_landmark();
+        if (lm.conjunctive) {
+            conjunctive_landmarks.push_back(node.get());
+            continue;
+        }
+        for (const FactPair &fact : lm.facts) {
+            if (fact.var >= static_cast<int>(landmarks_by_fact.size())) {
+                landmarks_by_fact.resize(fact.var + 1);
+            }
+            vector<vector<int>> &landmarks_by_value = landmarks_by_fact[fact.var];
+            if (landmarks_by_value.empty()) {
+                landmark_variables.push_back(fact.var);
+            }
+            if (fact.value >= static_cast<int>(landmarks_by_value.size())) {
+                landmarks_by_value.resize(fact.value + 1);
+            }
+            landmarks_by_value[fact.value].push_back(node->get_id());
+        }
+    }
+    goal_landmarks_mask.assign(num_blocks, 0);
+    for (LandmarkNode *node : goal_landmarks) {
+        int id = node->get_id();
+        goal_landmarks_mask[BitsetMath::block_index(id)] |=
+            BitsetMath::bit_mask(id);
+    }
+    parent_true_landmarks.resize(num_blocks);
+    true_landmarks.resize(num_blocks);
 }
 
 BitsetView LandmarkStatusManager::get_past_landmarks(const State &state) {
@@ -93,6 +124,8 @@ ConstBitsetView LandmarkStatusManager::get_future_landmarks(const State &state)
 void LandmarkStatusManager::progress_initial_state(const State &initial_state) {
     BitsetView past = get_past_landmarks(initial_state);
     BitsetView future = get_future_landmarks(initial_state);
+    // A new search might reuse the address of an old state registry.
+    parent_registry = nullptr;
 
     for (auto &node : lm_graph.get_nodes()) {
         int id = node->get_id();
@@ -125,6 +158,28 @@ void LandmarkStatusManager::progress_initial_state(const State &initial_state) {
     }
 }
 
+void LandmarkStatusManager::compute_true_landmarks(
+    const State &ancestor_state, vector<BitsetMath::Block> &result) const {
+    fill(result.begin(), result.end(), 0);
+    ancestor_state.unpack();
+    const vector<int> &values = ancestor_state.get_unpacked_values();
+    for (int var : landmark_variables) {
+        const vector<vector<int>> &landmarks_by_value = landmarks_by_fact[var];
+        int value = values[var];
+        if (value < static_cast<int>(landmarks_by_value.size())) {
+            for (int id : landmarks_by_value[value]) {
+                result[BitsetMath::block_index(id)] |= BitsetMath::bit_mask(id);
+            }
+        }
+    }
+    for (LandmarkNode *node : conjunctive_landmarks) {
+        if (node->get_landmark().is_true_in_state(ancestor_state)) {
+            int id = node->get_id();
+            result[BitsetMath::block_index(id)] |= BitsetMath::bit_mask(id);
+        }
+    }
+}
+
 void LandmarkStatusManager::progress(
     const State &parent_ancestor_state, OperatorID,
     const State &ancestor_state) {
@@ -144,63 +199,68 @@ void LandmarkStatusManager::progress(
     assert(future.size() == lm_graph.get_num_landmarks());
     assert(parent_future.size() == lm_graph.get_num_landmarks());
 
-    progress_landmarks(
-        parent_past, parent_future, parent_ancestor_state,
-        past, future, ancestor_state);
-    progress_goals(ancestor_state, future);
-    progress_greedy_necessary_orderings(ancestor_state, past, future);
+    /*
+      Search algorithms usually progress all successors of a state one
+      after the other, so we only recompute the landmarks that hold in the
+      parent when the parent changes.
+    */
+    if (parent_ancestor_state.get_registry() != parent_registry ||
+        parent_ancestor_state.get_id() != parent_id) {
+        compute_true_landmarks(parent_ancestor_state, parent_true_landmarks);
+        parent_registry = parent_ancestor_state.get_registry();
+        parent_id = parent_ancestor_state.get_id();
+    }
+    compute_true_landmarks(ancestor_state, true_landmarks);
+
+    progress_landmarks(parent_past, parent_future, past, future);
+    progress_goals(future);
+    progress_greedy_necessary_orderings(past, future);
     progress_reasonable_orderings(past, future);
 }
 
 void LandmarkStatusManager::progress_landmarks(
     ConstBitsetView &parent_past, ConstBitsetView &parent_future,
-    const State &parent_ancestor_state, BitsetView &past,
-    BitsetView &future, const State &ancestor_state) {
-    for (auto &node : lm_graph.get_nodes()) {
-        int id = node->get_id();
-        const Landmark &lm = node->get_landmark();
-        if (parent_future.test(id)) {
-            if (!lm.is_true_in_state(ancestor_state)) {
-                /*
-                  A landmark that is future in the parent remains future
-                  if it does not hold in the current state. If it also
-                  wasn't past in the parent, it remains not past.
-                */
-                future.set(id);
-                if (!parent_past.test(id)) {
-                    past.reset(id);
-                }
-            } else if (lm.is_true_in_state(parent_ancestor_state)) {
-                /*
-                  If the landmark held in the parent already, then it
-                  was not added by this transition and should remain
-                  future.
-                */
-                assert(parent_past.test(id));
-                future.set(id);
-            }
-        }
+    BitsetView &past, BitsetView &future) {
+    for (int i = 0; i < past.get_num_blocks(); ++i) {
+        BitsetMath::Block parent_future_block = parent_future.get_block(i);
+        BitsetMath::Block holds = true_landmarks[i];
+        BitsetMath::Block held_in_parent = parent_true_landmarks[i];
+        assert((held_in_parent & ~parent_past.get_block(i)) == BitsetMath::zeros);
+        /*
+          A landmark that is future in the parent remains future if it does
+          not hold in the current state. If it also wasn't past in the
+          parent, it remains not past. If the landmark held in the parent
+          already, then it was not added by this transition and should
+          remain future.
+        */
+        future.get_block(i) |= parent_future_block & (~holds | held_in_parent);
+        past.get_block(i) &=
+            ~(parent_future_block & ~holds & ~parent_past.get_block(i));
     }
 }
 
-void LandmarkStatusManager::progress_goals(const State &ancestor_state,
-                                           BitsetView &future) {
-    for (auto &node : goal_landmarks) {
-        if (!node->get_landmark().is_true_in_state(ancestor_state)) {
-            future.set(node->get_id());
-        }
+void LandmarkStatusManager::progress_goals(BitsetView &future) {
+    for (int i = 0; i < future.get_num_blocks(); ++i) {
+        future.get_block(i) |= goal_landmarks_mask[i] & ~true_landmarks[i];
     }
 }
 
+static bool test_bit(const vector<BitsetMath::Block> &bits, int index) {
+    return (bits[BitsetMath::block_index(index)] & BitsetMath::bit_mask(index))
+           != BitsetMath::zeros;
+}
+
 void LandmarkStatusManager::progress_greedy_necessary_orderings(
-    const State &ancestor_state, const BitsetView &past, BitsetView &future) {
+    const BitsetView &past, BitsetView &future) {
     for (auto &[tail, children] : greedy_necessary_children) {
-        const Landmark &lm = tail->get_landmark();
+        int tail_id = tail->get_id();
         assert(!children.empty());
+        if (future.test(tail_id) || test_bit(true_landmarks, tail_id)) {
+            continue;
+        }
         for (auto &child : children) {
-            if (!past.test(child->get_id())
-                && !lm.is_true_in_state(ancestor_state)) {
-                future.set(tail->get_id());
+            if (!past.test(child->get_id())) {
+                future.set(tail_id);
                 break;
             }
         }
@@ -211,6 +271,9 @@ void LandmarkStatusManager::progress_reasonable_orderings(
     const BitsetView &past, BitsetView &future) {
     for (auto &[head, parents] : reasonable_parents) {
         assert(!parents.empty());
+        if (future.test(head->get_id())) {
+            continue;
+        }
         for (auto &parent : parents) {
             if (!past.test(parent->get_id())) {
                 future.set(head->get_id());
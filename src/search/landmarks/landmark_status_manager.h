@@ -18,14 +18,32 @@ class LandmarkStatusManager {
     PerStateBitset past_landmarks;
     PerStateBitset future_landmarks;
 
+    /*
+      For progression, we compute the landmarks that hold in the parent and
+      in the current state as bitsets and then update the past and future
+      landmarks with word-wise operations. For each fact we store the
+      simple and disjunctive landmarks it makes true. Conjunctive
+      landmarks are checked separately.
+    */
+    std::vector<std::vector<std::vector<int>>> landmarks_by_fact;
+    std::vector<int> landmark_variables;
+    std::vector<LandmarkNode *> conjunctive_landmarks;
+    std::vector<BitsetMath::Block> goal_landmarks_mask;
+    std::vector<BitsetMath::Block> parent_true_landmarks;
+    std::vector<BitsetMath::Block> true_landmarks;
+    // The parent state for which parent_true_landmarks is computed.
+    const StateRegistry *parent_registry;
+    StateID parent_id;
+
+    void compute_true_landmarks(
+        const State &ancestor_state,
+        std::vector<BitsetMath::Block> &result) const;
     void progress_landmarks(
         ConstBitsetView &parent_past, ConstBitsetView &parent_future,
-        const State &parent_ancestor_state, BitsetView &past,
-        BitsetView &future, const State &ancestor_state);
-    void progress_goals(const State &ancestor_state, BitsetView &future);
+        BitsetView &past, BitsetView &future);
+    void progress_goals(BitsetView &future);
     void progress_greedy_necessary_orderings(
-        const State &ancestor_state, const BitsetView &past,
-        BitsetView &future);
+        const BitsetView &past, BitsetView &future);
     void progress_reasonable_orderings(
         const BitsetView &past, BitsetView &future);
 public:
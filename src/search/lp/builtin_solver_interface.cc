@@ -0,0 +1,1048 @@
+#include "builtin_solver_interface.h"
+
+#include "lp_solver.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace lp {
+static const double PRIMAL_FEASIBILITY_TOLERANCE = 1e-7;
+static const double DUAL_FEASIBILITY_TOLERANCE = 1e-7;
+static const double PIVOT_TOLERANCE = 1e-7;
+// Entries of eta vectors below this value are dropped.
+static const double DROP_TOLERANCE = 1e-12;
+static const int REFACTORIZATION_INTERVAL = 100;
+static const double INITIAL_ARTIFICIAL_BOUND = 1e6;
+static const double MAX_ARTIFICIAL_BOUND = 1e12;
+static const int MAX_ROUNDS = 10;
+static const int MAX_INCREMENTAL_SOLVES = 100;
+
+static bool is_finite(double bound) {
+    return !isinf(bound);
+}
+
+BuiltinSolverInterface::BuiltinSolverInterface()
+    : SolverInterface(),
+      num_structural_variables(0),
+      num_permanent_constraints(0),
+      num_temporary_constraints(0),
+      objective_sign(1),
+      factorization_is_valid(false),
+      num_factorization_etas(0),
+      has_artificial_bounds(false),
+      ignore_objective(false),
+      reduced_costs_are_valid(false),
+      values_are_valid(false),
+      num_incremental_solves(0),
+      solution_status(SolutionStatus::NOT_SOLVED),
+      num_iterations(0),
+      num_solves(0),
+      num_refactorizations(0) {
+}
+
+int BuiltinSolverInterface::get_num_rows() const {
+    return num_permanent_constraints + num_temporary_constraints;
+}
+
+int BuiltinSolverInterface::get_num_total_variables() const {
+    return num_structural_variables + get_num_rows();
+}
+
+double BuiltinSolverInterface::get_cost(int var) const {
+    if (var < num_structural_variables && !ignore_objective) {
+        return objective_sign * objective[var];
+    }
+    return 0;
+}
+
+double BuiltinSolverInterface::get_nonbasic_value(int var) const {
+    switch (statuses[var]) {
+    case VariableStatus::AT_LOWER:
+        return working_lower_bounds[var];
+    case VariableStatus::AT_UPPER:
+        return working_upper_bounds[var];
+    case VariableStatus::FREE:
+        return 0;
+    default:
+        ABORT("Basic variables have no fixed value.");
+    }
+}
+
+BuiltinSolverInterface::VariableStatus BuiltinSolverInterface::get_nonbasic_status(
+    int var, double value) const {
+    double lower = lower_bounds[var];
+    double upper = upper_bounds[var];
+    if (is_finite(lower) && is_finite(upper)) {
+        return (value - lower <= upper - value) ?
+               VariableStatus::AT_LOWER : VariableStatus::AT_UPPER;
+    } else if (is_finite(lower)) {
+        return VariableStatus::AT_LOWER;
+    } else if (is_finite(upper)) {
+        return VariableStatus::AT_UPPER;
+    } else {
+        return VariableStatus::FREE;
+    }
+}
+
+void BuiltinSolverInterface::load_column(int var, vector<double> &column) const {
+    column.assign(get_num_rows(), 0);
+    if (var < num_structural_variables) {
+        for (const Entry &entry : columns[var]) {
+            column[entry.row] = entry.value;
+        }
+    } else {
+        column[var - num_structural_variables] = -1;
+    }
+}
+
+double BuiltinSolverInterface::compute_dot_product(
+    int var, const vector<double> &row) const {
+    if (var < num_structural_variables) {
+        double result = 0;
+        for (const Entry &entry : columns[var]) {
+            result += entry.value * row[entry.row];
+        }
+        return result;
+    }
+    return -row[var - num_structural_variables];
+}
+
+void BuiltinSolverInterface::ftran(vector<double> &vec) const {
+    for (double &value : vec) {
+        value = -value;
+    }
+    int num_etas = eta_positions.size();
+    for (int eta = 0; eta < num_etas; ++eta) {
+        int position = eta_positions[eta];
+        double factor = vec[position];
+        if (factor == 0) {
+            continue;
+        }
+        vec[position] = eta_pivots[eta] * factor;
+        for (int i = eta_starts[eta]; i < eta_starts[eta + 1]; ++i) {
+            vec[eta_indices[i]] += eta_values[i] * factor;
+        }
+    }
+}
+
+void BuiltinSolverInterface::btran(vector<double> &vec) const {
+    for (int eta = eta_positions.size() - 1; eta >= 0; --eta) {
+        int position = eta_positions[eta];
+        double value = eta_pivots[eta] * vec[position];
+        for (int i = eta_starts[eta]; i < eta_starts[eta + 1]; ++i) {
+            value += eta_values[i] * vec[eta_indices[i]];
+        }
+        vec[position] = value;
+    }
+    for (double &value : vec) {
+        value = -value;
+    }
+}
+
+void BuiltinSolverInterface::add_eta(int position, const vector<double> &column) {
+    double pivot = column[position];
+    assert(fabs(pivot) >= PIVOT_TOLERANCE);
+    eta_positions.push_back(position);
+    eta_pivots.push_back(1 / pivot);
+    int num_rows = column.size();
+    for (int i = 0; i < num_rows; ++i) {
+        if (i != position && fabs(column[i]) > DROP_TOLERANCE) {
+            eta_indices.push_back(i);
+            eta_values.push_back(-column[i] / pivot);
+        }
+    }
+    eta_starts.push_back(eta_indices.size());
+}
+
+void BuiltinSolverInterface::refactor() {
+    /*
+      Start from the basis of all logical variables and replace logical
+      variables that should not be basic by the basic structural variables
+      one by one. Structural variables whose columns are (numerically)
+      linearly dependent on the previous ones become nonbasic and logical
+      variables fill the remaining positions, so this also repairs bases
+      that are singular or have the wrong size.
+    */
+    int num_rows = get_num_rows();
+    eta_positions.clear();
+    eta_pivots.clear();
+    eta_starts.assign(1, 0);
+    eta_indices.clear();
+    eta_values.clear();
+    basis_head.resize(num_rows);
+    vector<bool> is_replaceable(num_rows);
+    for (int position = 0; position < num_rows; ++position) {
+        int logical = num_structural_variables + position;
+        basis_head[position] = logical;
+        is_replaceable[position] = statuses[logical] != VariableStatus::BASIC;
+    }
+
+    vector<int> basic_structural_variables;
+    for (int var = 0; var < num_structural_variables; ++var) {
+        if (statuses[var] == VariableStatus::BASIC) {
+            basic_structural_variables.push_back(var);
+        }
+    }
+    // Sparse columns first to reduce the fill-in of the eta vectors.
+    stable_sort(basic_structural_variables.begin(),
+                basic_structural_variables.end(),
+                [&](int var1, int var2) {
+                    return columns[var1].size() < columns[var2].size();
+                });
+
+    vector<double> column;
+    for (int var : basic_structural_variables) {
+        load_column(var, column);
+        ftran(column);
+        int best_position = -1;
+        double best_pivot = PIVOT_TOLERANCE;
+        for (int position = 0; position < num_rows; ++position) {
+            if (is_replaceable[position] && fabs(column[position]) >= best_pivot) {
+                best_position = position;
+                best_pivot = fabs(column[position]);
+            }
+        }
+        if (best_position == -1) {
+            statuses[var] = get_nonbasic_status(var, values[var]);
+        } else {
+            add_eta(best_position, column);
+            basis_head[best_position] = var;
+            is_replaceable[best_position] = false;
+        }
+    }
+    for (int position = 0; position < num_rows; ++position) {
+        if (is_replaceable[position]) {
+            statuses[num_structural_variables + position] = VariableStatus::BASIC;
+        }
+    }
+    edge_weights.assign(num_rows, 1);
+    num_factorization_etas = eta_positions.size();
+    factorization_is_valid = true;
+    ++num_refactorizations;
+}
+
+void BuiltinSolverInterface::compute_primal_values() {
+    int num_variables = get_num_total_variables();
+    vector<double> rhs(get_num_rows(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        if (statuses[var] == VariableStatus::BASIC) {
+            continue;
+        }
+        double value = get_nonbasic_value(var);
+        values[var] = value;
+        if (value == 0) {
+            continue;
+        }
+        if (var < num_structural_variables) {
+            for (const Entry &entry : columns[var]) {
+                rhs[entry.row] -= entry.value * value;
+            }
+        } else {
+            rhs[var - num_structural_variables] += value;
+        }
+    }
+    ftran(rhs);
+    int num_rows = get_num_rows();
+    for (int position = 0; position < num_rows; ++position) {
+        values[basis_head[position]] = rhs[position];
+    }
+}
+
+void BuiltinSolverInterface::compute_reduced_costs() {
+    int num_rows = get_num_rows();
+    vector<double> duals(num_rows);
+    for (int position = 0; position < num_rows; ++position) {
+        duals[position] = get_cost(basis_head[position]);
+    }
+    btran(duals);
+    int num_variables = get_num_total_variables();
+    for (int var = 0; var < num_variables; ++var) {
+        if (statuses[var] == VariableStatus::BASIC) {
+            reduced_costs[var] = 0;
+        } else {
+            reduced_costs[var] = get_cost(var) - compute_dot_product(var, duals);
+        }
+    }
+}
+
+bool BuiltinSolverInterface::set_dual_feasible_status(
+    int var, double artificial_bound) {
+    /*
+      Put the nonbasic variable at the bound that makes its reduced cost
+      dual feasible. If that bound is infinite, we introduce an artificial
+      bound instead. Return true if we introduced an artificial bound.
+    */
+    assert(statuses[var] != VariableStatus::BASIC);
+    VariableStatus &status = statuses[var];
+    double lower = lower_bounds[var];
+    double upper = upper_bounds[var];
+    double reduced_cost = reduced_costs[var];
+    bool wants_lower = reduced_cost > DUAL_FEASIBILITY_TOLERANCE;
+    bool wants_upper = reduced_cost < -DUAL_FEASIBILITY_TOLERANCE;
+    if (lower == upper) {
+        status = VariableStatus::AT_LOWER;
+    } else if (is_finite(lower) && is_finite(upper)) {
+        if (wants_lower) {
+            status = VariableStatus::AT_LOWER;
+        } else if (wants_upper) {
+            status = VariableStatus::AT_UPPER;
+        } else if (status == VariableStatus::FREE) {
+            status = VariableStatus::AT_LOWER;
+        }
+    } else if (is_finite(lower)) {
+        if (wants_upper) {
+            working_upper_bounds[var] = lower + artificial_bound;
+            status = VariableStatus::AT_UPPER;
+            return true;
+        }
+        status = VariableStatus::AT_LOWER;
+    } else if (is_finite(upper)) {
+        if (wants_lower) {
+            working_lower_bounds[var] = upper - artificial_bound;
+            status = VariableStatus::AT_LOWER;
+            return true;
+        }
+        status = VariableStatus::AT_UPPER;
+    } else {
+        if (wants_lower) {
+            working_lower_bounds[var] = -artificial_bound;
+            status = VariableStatus::AT_LOWER;
+            return true;
+        } else if (wants_upper) {
+            working_upper_bounds[var] = artificial_bound;
+            status = VariableStatus::AT_UPPER;
+            return true;
+        }
+        status = VariableStatus::FREE;
+    }
+    return false;
+}
+
+bool BuiltinSolverInterface::make_dual_feasible(double artificial_bound) {
+    working_lower_bounds = lower_bounds;
+    working_upper_bounds = upper_bounds;
+    has_artificial_bounds = false;
+    int num_variables = get_num_total_variables();
+    for (int var = 0; var < num_variables; ++var) {
+        if (statuses[var] != VariableStatus::BASIC &&
+            set_dual_feasible_status(var, artificial_bound)) {
+            has_artificial_bounds = true;
+        }
+    }
+    return has_artificial_bounds;
+}
+
+bool BuiltinSolverInterface::update_changed_variables() {
+    /*
+      Move nonbasic variables with changed bounds to their new bounds and
+      update the values of the basic variables accordingly. Return false
+      if this would need artificial bounds.
+    */
+    assert(reduced_costs_are_valid && values_are_valid && !has_artificial_bounds);
+    int num_rows = get_num_rows();
+    for (int var : changed_bound_variables) {
+        working_lower_bounds[var] = lower_bounds[var];
+        working_upper_bounds[var] = upper_bounds[var];
+        if (statuses[var] == VariableStatus::BASIC) {
+            continue;
+        }
+        if (set_dual_feasible_status(var, 0)) {
+            return false;
+        }
+        double value = get_nonbasic_value(var);
+        double delta = value - values[var];
+        if (delta == 0) {
+            continue;
+        }
+        values[var] = value;
+        load_column(var, pivot_column);
+        ftran(pivot_column);
+        for (int position = 0; position < num_rows; ++position) {
+            if (pivot_column[position] != 0) {
+                values[basis_head[position]] -= delta * pivot_column[position];
+            }
+        }
+    }
+    return true;
+}
+
+int BuiltinSolverInterface::choose_leaving_position() const {
+    int best_position = -1;
+    double best_score = 0;
+    int num_rows = get_num_rows();
+    for (int position = 0; position < num_rows; ++position) {
+        int var = basis_head[position];
+        double value = values[var];
+        double infeasibility;
+        if (value < working_lower_bounds[var] - PRIMAL_FEASIBILITY_TOLERANCE) {
+            infeasibility = working_lower_bounds[var] - value;
+        } else if (value > working_upper_bounds[var] + PRIMAL_FEASIBILITY_TOLERANCE) {
+            infeasibility = value - working_upper_bounds[var];
+        } else {
+            continue;
+        }
+        double score = infeasibility * infeasibility / edge_weights[position];
+        if (score > best_score) {
+            best_position = position;
+            best_score = score;
+        }
+    }
+    return best_position;
+}
+
+BuiltinSolverInterface::SimplexResult BuiltinSolverInterface::run_dual_simplex() {
+    int num_rows = get_num_rows();
+    int num_variables = get_num_total_variables();
+    long long max_iterations = num_iterations + max(10000, 20 * num_variables);
+    pivot_row.resize(num_rows);
+    alphas.resize(num_variables);
+    // The caller computes or updates the values before we start.
+    bool values_are_fresh = true;
+    while (true) {
+        if (num_iterations >= max_iterations) {
+            return SimplexResult::ITERATION_LIMIT;
+        }
+        if (static_cast<int>(eta_positions.size()) - num_factorization_etas
+            >= REFACTORIZATION_INTERVAL) {
+            refactor();
+            compute_primal_values();
+            compute_reduced_costs();
+        }
+
+        int leaving_position = choose_leaving_position();
+        if (leaving_position == -1) {
+            /*
+              Recompute the values of the basic variables to make sure that
+              the solution is primal feasible and not only looks like it
+              because of accumulated rounding errors.
+            */
+            if (values_are_fresh) {
+                return SimplexResult::OPTIMAL;
+            }
+            compute_primal_values();
+            values_are_fresh = true;
+            continue;
+        }
+
+        int leaving_var = basis_head[leaving_position];
+        bool leaves_at_lower = values[leaving_var] < working_lower_bounds[leaving_var];
+        double target_value = leaves_at_lower ?
+            working_lower_bounds[leaving_var] : working_upper_bounds[leaving_var];
+        double primal_step = values[leaving_var] - target_value;
+        double direction = leaves_at_lower ? -1 : 1;
+
+        fill(pivot_row.begin(), pivot_row.end(), 0);
+        pivot_row[leaving_position] = 1;
+        btran(pivot_row);
+
+        /*
+          Harris ratio test: first compute the maximal dual step length
+          with relaxed bounds on the reduced costs, then choose the
+          candidate with the largest pivot element among those whose
+          ratio is below the maximal step length.
+        */
+        candidates.clear();
+        double max_ratio = numeric_limits<double>::infinity();
+        for (int var = 0; var < num_variables; ++var) {
+            VariableStatus status = statuses[var];
+            if (status == VariableStatus::BASIC) {
+                continue;
+            }
+            double alpha = compute_dot_product(var, pivot_row);
+            alphas[var] = alpha;
+            if (working_lower_bounds[var] == working_upper_bounds[var]) {
+                continue;
+            }
+            double signed_alpha = direction * alpha;
+            double reduced_cost = reduced_costs[var];
+            if (signed_alpha > PIVOT_TOLERANCE &&
+                (status == VariableStatus::AT_LOWER || status == VariableStatus::FREE)) {
+                max_ratio = min(
+                    max_ratio, (reduced_cost + DUAL_FEASIBILITY_TOLERANCE) / signed_alpha);
+                candidates.push_back(var);
+            } else if (signed_alpha < -PIVOT_TOLERANCE &&
+                       (status == VariableStatus::AT_UPPER || status == VariableStatus::FREE)) {
+                max_ratio = min(
+                    max_ratio, (reduced_cost - DUAL_FEASIBILITY_TOLERANCE) / signed_alpha);
+                candidates.push_back(var);
+            }
+        }
+        if (candidates.empty()) {
+            return SimplexResult::INFEASIBLE;
+        }
+        int entering_var = -1;
+        double largest_alpha = 0;
+        for (int var : candidates) {
+            double signed_alpha = direction * alphas[var];
+            if (reduced_costs[var] / signed_alpha <= max_ratio &&
+                fabs(signed_alpha) > largest_alpha) {
+                entering_var = var;
+                largest_alpha = fabs(signed_alpha);
+            }
+        }
+        assert(entering_var != -1);
+
+        load_column(entering_var, pivot_column);
+        ftran(pivot_column);
+        double pivot = pivot_column[leaving_position];
+        if (fabs(pivot - alphas[entering_var]) > 1e-6 * (1 + fabs(pivot)) ||
+            fabs(pivot) < PIVOT_TOLERANCE) {
+            if (static_cast<int>(eta_positions.size()) > num_factorization_etas) {
+                // The pivot row and column disagree: refactor and retry.
+                refactor();
+                compute_primal_values();
+                compute_reduced_costs();
+                continue;
+            }
+            if (fabs(pivot) < PIVOT_TOLERANCE) {
+                return SimplexResult::ITERATION_LIMIT;
+            }
+        }
+
+        // Update the reduced costs.
+        double dual_step = direction * max(
+            0.0, reduced_costs[entering_var] / (direction * alphas[entering_var]));
+        if (dual_step != 0) {
+            for (int var = 0; var < num_variables; ++var) {
+                if (statuses[var] != VariableStatus::BASIC) {
+                    reduced_costs[var] -= dual_step * alphas[var];
+                }
+            }
+        }
+        reduced_costs[entering_var] = 0;
+        reduced_costs[leaving_var] = -dual_step;
+
+        // Update the primal values.
+        double entering_step = primal_step / pivot;
+        for (int position = 0; position < num_rows; ++position) {
+            if (pivot_column[position] != 0) {
+                values[basis_head[position]] -= entering_step * pivot_column[position];
+            }
+        }
+        values[entering_var] += entering_step;
+        values[leaving_var] = target_value;
+
+        // Update the dual steepest edge weights.
+        double leaving_weight = 0;
+        for (double value : pivot_row) {
+            leaving_weight += value * value;
+        }
+        tau = pivot_row;
+        ftran(tau);
+        for (int position = 0; position < num_rows; ++position) {
+            double alpha = pivot_column[position];
+            if (position == leaving_position || alpha == 0) {
+                continue;
+            }
+            double ratio = alpha / pivot;
+            double weight = edge_weights[position] - 2 * ratio * tau[position] +
+                ratio * ratio * leaving_weight;
+            edge_weights[position] = max(weight, ratio * ratio);
+        }
+        edge_weights[leaving_position] = max(leaving_weight / (pivot * pivot), 1e-12);
+
+        // Update the basis.
+        add_eta(leaving_position, pivot_column);
+        basis_head[leaving_position] = entering_var;
+        statuses[entering_var] = VariableStatus::BASIC;
+        statuses[leaving_var] = leaves_at_lower ?
+            VariableStatus::AT_LOWER : VariableStatus::AT_UPPER;
+        values_are_fresh = false;
+        ++num_iterations;
+    }
+}
+
+BuiltinSolverInterface::SolutionStatus BuiltinSolverInterface::check_feasibility() {
+    /*
+      Without an objective, all reduced costs are zero, so the current basis
+      is dual feasible without artificial bounds and the dual simplex method
+      only searches for a primal feasible solution.
+    */
+    ignore_objective = true;
+    compute_reduced_costs();
+    make_dual_feasible(0);
+    compute_primal_values();
+    SimplexResult result = run_dual_simplex();
+    ignore_objective = false;
+    if (result == SimplexResult::OPTIMAL) {
+        return SolutionStatus::OPTIMAL;
+    } else if (result == SimplexResult::INFEASIBLE) {
+        return SolutionStatus::INFEASIBLE;
+    } else {
+        return SolutionStatus::ITERATION_LIMIT;
+    }
+}
+
+void BuiltinSolverInterface::invalidate_solution() {
+    solution_status = SolutionStatus::NOT_SOLVED;
+}
+
+void BuiltinSolverInterface::load_problem(const LinearProgram &lp) {
+    for (const LPVariable &var : lp.get_variables()) {
+        if (var.is_integer) {
+            cout << "The builtin LP solver does not support integer variables" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+    const named_vector::NamedVector<LPVariable> &variables = lp.get_variables();
+    const named_vector::NamedVector<LPConstraint> &constraints = lp.get_constraints();
+    num_structural_variables = variables.size();
+    num_permanent_constraints = constraints.size();
+    num_temporary_constraints = 0;
+    objective_sign = (lp.get_sense() == LPObjectiveSense::MINIMIZE) ? 1 : -1;
+
+    columns.assign(num_structural_variables, {});
+    objective.clear();
+    lower_bounds.clear();
+    upper_bounds.clear();
+    for (const LPVariable &var : variables) {
+        objective.push_back(var.objective_coefficient);
+        lower_bounds.push_back(var.lower_bound);
+        upper_bounds.push_back(var.upper_bound);
+    }
+    for (int row = 0; row < num_permanent_constraints; ++row) {
+        const LPConstraint &constraint = constraints[row];
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coefficients = constraint.get_coefficients();
+        for (size_t i = 0; i < vars.size(); ++i) {
+            if (coefficients[i] != 0) {
+                columns[vars[i]].push_back({row, coefficients[i]});
+            }
+        }
+        lower_bounds.push_back(constraint.get_lower_bound());
+        upper_bounds.push_back(constraint.get_upper_bound());
+    }
+
+    int num_variables = get_num_total_variables();
+    working_lower_bounds = lower_bounds;
+    working_upper_bounds = upper_bounds;
+    statuses.assign(num_variables, VariableStatus::BASIC);
+    values.assign(num_variables, 0);
+    reduced_costs.assign(num_variables, 0);
+    for (int var = 0; var < num_structural_variables; ++var) {
+        statuses[var] = get_nonbasic_status(var, 0);
+    }
+    factorization_is_valid = false;
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::add_temporary_constraints(
+    const named_vector::NamedVector<LPConstraint> &constraints) {
+    for (const LPConstraint &constraint : constraints) {
+        int row = get_num_rows();
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coefficients = constraint.get_coefficients();
+        for (size_t i = 0; i < vars.size(); ++i) {
+            if (coefficients[i] != 0) {
+                columns[vars[i]].push_back({row, coefficients[i]});
+            }
+        }
+        lower_bounds.push_back(constraint.get_lower_bound());
+        upper_bounds.push_back(constraint.get_upper_bound());
+        working_lower_bounds.push_back(constraint.get_lower_bound());
+        working_upper_bounds.push_back(constraint.get_upper_bound());
+        statuses.push_back(VariableStatus::BASIC);
+        values.push_back(0);
+        reduced_costs.push_back(0);
+        ++num_temporary_constraints;
+    }
+    factorization_is_valid = false;
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::clear_temporary_constraints() {
+    if (!has_temporary_constraints()) {
+        return;
+    }
+    for (vector<Entry> &column : columns) {
+        while (!column.empty() && column.back().row >= num_permanent_constraints) {
+            column.pop_back();
+        }
+    }
+    num_temporary_constraints = 0;
+    int num_variables = get_num_total_variables();
+    lower_bounds.resize(num_variables);
+    upper_bounds.resize(num_variables);
+    working_lower_bounds.resize(num_variables);
+    working_upper_bounds.resize(num_variables);
+    statuses.resize(num_variables);
+    values.resize(num_variables);
+    reduced_costs.resize(num_variables);
+    factorization_is_valid = false;
+    invalidate_solution();
+}
+
+double BuiltinSolverInterface::get_infinity() const {
+    return numeric_limits<double>::infinity();
+}
+
+void BuiltinSolverInterface::set_objective_coefficients(const vector<double> &coefficients) {
+    assert(static_cast<int>(coefficients.size()) == num_structural_variables);
+    objective = coefficients;
+    reduced_costs_are_valid = false;
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_objective_coefficient(int index, double coefficient) {
+    objective[index] = coefficient;
+    reduced_costs_are_valid = false;
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_constraint_lower_bound(int index, double bound) {
+    lower_bounds[num_structural_variables + index] = bound;
+    changed_bound_variables.push_back(num_structural_variables + index);
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_constraint_upper_bound(int index, double bound) {
+    upper_bounds[num_structural_variables + index] = bound;
+    changed_bound_variables.push_back(num_structural_variables + index);
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_variable_lower_bound(int index, double bound) {
+    lower_bounds[index] = bound;
+    changed_bound_variables.push_back(index);
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_variable_upper_bound(int index, double bound) {
+    upper_bounds[index] = bound;
+    changed_bound_variables.push_back(index);
+    invalidate_solution();
+}
+
+void BuiltinSolverInterface::set_mip_gap(double /*gap*/) {
+    /*
+      The builtin solver does not support MIPs, so there is nothing to do
+      here. As for SoPlex, loading a problem with integer variables leads
+      to an error.
+    */
+}
+
+BuiltinSolverInterface::SolutionStatus BuiltinSolverInterface::solve_from_scratch() {
+    reduced_costs_are_valid = false;
+    values_are_valid = false;
+    double artificial_bound = INITIAL_ARTIFICIAL_BOUND;
+    for (int round = 0; round < MAX_ROUNDS; ++round) {
+        compute_reduced_costs();
+        make_dual_feasible(artificial_bound);
+        compute_primal_values();
+        SimplexResult result = run_dual_simplex();
+        if (result == SimplexResult::ITERATION_LIMIT) {
+            return SolutionStatus::ITERATION_LIMIT;
+        } else if (result == SimplexResult::INFEASIBLE) {
+            if (!has_artificial_bounds) {
+                reduced_costs_are_valid = true;
+                values_are_valid = true;
+                return SolutionStatus::INFEASIBLE;
+            }
+            // The artificial bounds might cause the infeasibility.
+            SolutionStatus feasibility = check_feasibility();
+            if (feasibility != SolutionStatus::OPTIMAL) {
+                return feasibility;
+            }
+            if (artificial_bound < MAX_ARTIFICIAL_BOUND) {
+                artificial_bound *= 1000;
+                continue;
+            }
+            return SolutionStatus::UNBOUNDED;
+        }
+        if (!has_artificial_bounds) {
+            reduced_costs_are_valid = true;
+            values_are_valid = true;
+            return SolutionStatus::OPTIMAL;
+        }
+
+        /*
+          Variables with non-zero reduced costs at an artificial bound
+          would improve the objective if we moved them further, so the LP
+          is unbounded or the artificial bound is too small. Variables with
+          zero reduced costs can move back to their actual bounds.
+        */
+        bool has_active_artificial_bound = false;
+        bool moved_variable = false;
+        int num_variables = get_num_total_variables();
+        for (int var = 0; var < num_variables; ++var) {
+            VariableStatus status = statuses[var];
+            bool at_artificial_bound =
+                (status == VariableStatus::AT_LOWER &&
+                 working_lower_bounds[var] != lower_bounds[var]) ||
+                (status == VariableStatus::AT_UPPER &&
+                 working_upper_bounds[var] != upper_bounds[var]);
+            if (!at_artificial_bound) {
+                continue;
+            }
+            if (fabs(reduced_costs[var]) <= DUAL_FEASIBILITY_TOLERANCE) {
+                statuses[var] = get_nonbasic_status(var, values[var]);
+                moved_variable = true;
+            } else {
+                has_active_artificial_bound = true;
+            }
+        }
+        if (has_active_artificial_bound) {
+            if (artificial_bound < MAX_ARTIFICIAL_BOUND) {
+                artificial_bound *= 1000;
+                continue;
+            }
+            /*
+              Solutions with values close to the artificial bound do not
+              prove that the LP is feasible because of rounding errors.
+            */
+            SolutionStatus feasibility = check_feasibility();
+            if (feasibility == SolutionStatus::OPTIMAL) {
+                return SolutionStatus::UNBOUNDED;
+            }
+            return feasibility;
+        }
+        if (!moved_variable) {
+            return SolutionStatus::OPTIMAL;
+        }
+    }
+    return SolutionStatus::ITERATION_LIMIT;
+}
+
+void BuiltinSolverInterface::solve() {
+    ++num_solves;
+    if (!factorization_is_valid) {
+        refactor();
+        reduced_costs_are_valid = false;
+        values_are_valid = false;
+    }
+    if (reduced_costs_are_valid && values_are_valid &&
+        num_incremental_solves < MAX_INCREMENTAL_SOLVES &&
+        static_cast<int>(changed_bound_variables.size()) <= get_num_rows() &&
+        update_changed_variables()) {
+        ++num_incremental_solves;
+        SimplexResult result = run_dual_simplex();
+        if (result == SimplexResult::OPTIMAL) {
+            solution_status = SolutionStatus::OPTIMAL;
+        } else if (result == SimplexResult::INFEASIBLE) {
+            solution_status = SolutionStatus::INFEASIBLE;
+        } else {
+            solution_status = SolutionStatus::ITERATION_LIMIT;
+            reduced_costs_are_valid = false;
+            values_are_valid = false;
+        }
+    } else {
+        num_incremental_solves = 0;
+        solution_status = solve_from_scratch();
+    }
+    changed_bound_variables.clear();
+}
+
+static void write_linear_expression(
+    ofstream &file, const vector<pair<int, double>> &entries) {
+    if (entries.empty()) {
+        file << " 0 x0";
+    }
+    for (const auto &[var, coefficient] : entries) {
+        file << (coefficient < 0 ? " - " : " + ") << fabs(coefficient)
+             << " x" << var;
+    }
+}
+
+void BuiltinSolverInterface::write_lp(const string &filename) const {
+    ofstream file(filename);
+    if (!file) {
+        cerr << "Could not write LP to file " << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    file.precision(numeric_limits<double>::max_digits10);
+    file << (objective_sign == 1 ? "Minimize" : "Maximize") << endl;
+    vector<pair<int, double>> objective_entries;
+    for (int var = 0; var < num_structural_variables; ++var) {
+        if (objective[var] != 0) {
+            objective_entries.emplace_back(var, objective[var]);
+        }
+    }
+    file << " obj:";
+    write_linear_expression(file, objective_entries);
+    file << endl;
+
+    int num_rows = get_num_rows();
+    vector<vector<pair<int, double>>> rows(num_rows);
+    for (int var = 0; var < num_structural_variables; ++var) {
+        for (const Entry &entry : columns[var]) {
+            rows[entry.row].emplace_back(var, entry.value);
+        }
+    }
+    file << "Subject To" << endl;
+    for (int row = 0; row < num_rows; ++row) {
+        double lower = lower_bounds[num_structural_variables + row];
+        double upper = upper_bounds[num_structural_variables + row];
+        if (lower == upper) {
+            file << " c" << row << ":";
+            write_linear_expression(file, rows[row]);
+            file << " = " << lower << endl;
+            continue;
+        }
+        if (is_finite(lower)) {
+            file << " c" << row << "_lb:";
+            write_linear_expression(file, rows[row]);
+            file << " >= " << lower << endl;
+        }
+        if (is_finite(upper)) {
+            file << " c" << row << "_ub:";
+            write_linear_expression(file, rows[row]);
+            file << " <= " << upper << endl;
+        }
+    }
+
+    file << "Bounds" << endl;
+    for (int var = 0; var < num_structural_variables; ++var) {
+        double lower = lower_bounds[var];
+        double upper = upper_bounds[var];
+        if (!is_finite(lower) && !is_finite(upper)) {
+            file << " x" << var << " free" << endl;
+            continue;
+        }
+        file << " ";
+        if (is_finite(lower)) {
+            file << lower;
+        } else {
+            file << "-inf";
+        }
+        file << " <= x" << var << " <= ";
+        if (is_finite(upper)) {
+            file << upper;
+        } else {
+            file << "inf";
+        }
+        file << endl;
+    }
+    file << "End" << endl;
+}
+
+void BuiltinSolverInterface::print_failure_analysis() const {
+    cout << "Builtin LP solver status: ";
+    switch (solution_status) {
+    case SolutionStatus::NOT_SOLVED:
+        cout << "LP has not been solved since it was last changed." << endl;
+        break;
+    case SolutionStatus::OPTIMAL:
+        cout << "LP has been solved to optimality." << endl;
+        break;
+    case SolutionStatus::INFEASIBLE:
+        cout << "LP has been proven to be primal infeasible." << endl;
+        break;
+    case SolutionStatus::UNBOUNDED:
+        cout << "LP is primal unbounded." << endl;
+        break;
+    case SolutionStatus::ITERATION_LIMIT:
+        cout << "Aborted after too many iterations or numerical troubles." << endl;
+        break;
+    }
+}
+
+bool BuiltinSolverInterface::is_infeasible() const {
+    assert(solution_status != SolutionStatus::NOT_SOLVED);
+    return solution_status == SolutionStatus::INFEASIBLE;
+}
+
+bool BuiltinSolverInterface::is_unbounded() const {
+    assert(solution_status != SolutionStatus::NOT_SOLVED);
+    return solution_status == SolutionStatus::UNBOUNDED;
+}
+
+bool BuiltinSolverInterface::has_optimal_solution() const {
+    assert(solution_status != SolutionStatus::NOT_SOLVED);
+    return solution_status == SolutionStatus::OPTIMAL;
+}
+
+double BuiltinSolverInterface::get_objective_value() const {
+    assert(has_optimal_solution());
+    double result = 0;
+    for (int var = 0; var < num_structural_variables; ++var) {
+        result += objective[var] * values[var];
+    }
+    return result;
+}
+
+vector<double> BuiltinSolverInterface::extract_solution() const {
+    assert(has_optimal_solution());
+    return vector<double>(values.begin(), values.begin() + num_structural_variables);
+}
+
+LPBasis BuiltinSolverInterface::get_basis() const {
+    assert(has_optimal_solution());
+    LPBasis basis;
+    for (int var = 0; var < num_structural_variables; ++var) {
+        basis.variable_status.push_back(static_cast<int8_t>(statuses[var]));
+    }
+    for (int row = 0; row < num_permanent_constraints; ++row) {
+        basis.constraint_status.push_back(
+            static_cast<int8_t>(statuses[num_structural_variables + row]));
+    }
+    return basis;
+}
+
+void BuiltinSolverInterface::set_basis(const LPBasis &basis) {
+    if (basis.empty()) {
+        return;
+    }
+    assert(static_cast<int>(basis.variable_status.size()) == num_structural_variables);
+    assert(static_cast<int>(basis.constraint_status.size()) == num_permanent_constraints);
+    /*
+      We only have to refactor if the set of basic variables changes and
+      only have to recompute the values if some status changes.
+    */
+    bool same_basic_variables = true;
+    bool same_statuses = true;
+    auto set_status = [&](int var, VariableStatus status) {
+        if (status != statuses[var]) {
+            same_statuses = false;
+            if ((status == VariableStatus::BASIC) !=
+                (statuses[var] == VariableStatus::BASIC)) {
+                same_basic_variables = false;
+            }
+        }
+        statuses[var] = status;
+    };
+    for (int var = 0; var < num_structural_variables; ++var) {
+        set_status(var, static_cast<VariableStatus>(basis.variable_status[var]));
+    }
+    for (int row = 0; row < num_permanent_constraints; ++row) {
+        set_status(num_structural_variables + row,
+                   static_cast<VariableStatus>(basis.constraint_status[row]));
+    }
+    for (int var = num_structural_variables + num_permanent_constraints;
+         var < get_num_total_variables(); ++var) {
+        set_status(var, VariableStatus::BASIC);
+    }
+    if (!same_basic_variables) {
+        factorization_is_valid = false;
+    }
+    if (!same_statuses) {
+        values_are_valid = false;
+    }
+    invalidate_solution();
+}
+
+int BuiltinSolverInterface::get_num_variables() const {
+    return num_structural_variables;
+}
+
+int BuiltinSolverInterface::get_num_constraints() const {
+    return get_num_rows();
+}
+
+bool BuiltinSolverInterface::has_temporary_constraints() const {
+    return num_temporary_constraints > 0;
+}
+
+void BuiltinSolverInterface::print_statistics() const {
+    cout << "LP solves: " << num_solves << endl;
+    cout << "LP simplex iterations: " << num_iterations << endl;
+    cout << "LP refactorizations: " << num_refactorizations << endl;
+}
+}
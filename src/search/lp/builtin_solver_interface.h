@@ -0,0 +1,185 @@
+#ifndef LP_BUILTIN_SOLVER_INTERFACE_H
+#define LP_BUILTIN_SOLVER_INTERFACE_H
+
+#include "solver_interface.h"
+
+#include <vector>
+
+namespace lp {
+/*
+  LP solver that is always compiled into the planner. It implements the
+  bounded dual simplex method on the problem
+
+    min c^T x  s.t.  r = Ax,  l <= (x, r) <= u,
+
+  i.e., every constraint i gets a logical variable r_i whose bounds are the
+  bounds of the constraint. The initial basis consists of all logical
+  variables. Since the heuristics we solve LPs for usually minimize
+  non-negative costs (or maximize with bounded variables), this basis is
+  dual feasible and no phase 1 is necessary. Otherwise, we temporarily
+  bound dual infeasible variables with large artificial bounds, and
+  increase or remove them once the LP is solved.
+
+  The constraint matrix is stored column-wise as sparse vectors. The basis
+  inverse is stored in product form as a sequence of sparse eta vectors on
+  top of the (negated identity) basis of the logical variables and is
+  recomputed from scratch after REFACTORIZATION_INTERVAL pivots, when
+  constraints are added or removed and when loading a different basis.
+  Leaving variables are chosen by dual steepest edge pricing and entering
+  variables by a Harris ratio test.
+
+  The solver is meant for LPs of small to medium size. It does not use
+  presolving or scaling and does not support integer variables.
+*/
+class BuiltinSolverInterface : public SolverInterface {
+    enum class VariableStatus {
+        BASIC, AT_LOWER, AT_UPPER, FREE
+    };
+
+    enum class SolutionStatus {
+        NOT_SOLVED, OPTIMAL, INFEASIBLE, UNBOUNDED, ITERATION_LIMIT
+    };
+
+    enum class SimplexResult {
+        OPTIMAL, INFEASIBLE, ITERATION_LIMIT
+    };
+
+    struct Entry {
+        int row;
+        double value;
+    };
+
+    int num_structural_variables;
+    int num_permanent_constraints;
+    int num_temporary_constraints;
+    // Entries of temporary constraints are at the end of each column.
+    std::vector<std::vector<Entry>> columns;
+    std::vector<double> objective;
+    // 1 for minimization, -1 for maximization.
+    double objective_sign;
+
+    /*
+      The following vectors have one entry per structural variable followed
+      by one entry per logical variable. The working bounds are the bounds
+      including the artificial bounds of the current solve.
+    */
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    std::vector<double> working_lower_bounds;
+    std::vector<double> working_upper_bounds;
+    std::vector<VariableStatus> statuses;
+    std::vector<double> values;
+    std::vector<double> reduced_costs;
+
+    // The variable in each position of the basis.
+    std::vector<int> basis_head;
+    // Dual steepest edge weights of the basis positions.
+    std::vector<double> edge_weights;
+
+    /*
+      Eta file: the inverse of the basis is E_k * ... * E_1 * (-I), where
+      E_i is the identity with column eta_positions[i] replaced by the eta
+      vector. The diagonal entry is stored in eta_pivots and the other
+      entries in eta_indices and eta_values from eta_starts[i] to
+      eta_starts[i + 1].
+    */
+    std::vector<int> eta_positions;
+    std::vector<double> eta_pivots;
+    std::vector<int> eta_starts;
+    std::vector<int> eta_indices;
+    std::vector<double> eta_values;
+    bool factorization_is_valid;
+    // Number of eta vectors created when computing the factorization.
+    int num_factorization_etas;
+
+    bool has_artificial_bounds;
+    // Ignore the objective, e.g., to test whether the LP is feasible.
+    bool ignore_objective;
+
+    /*
+      Between two calls to solve(), we keep the reduced costs and the
+      values of the variables if possible and only update the values of
+      nonbasic variables whose bounds changed. This avoids passes over the
+      whole LP when only a few bounds change, e.g., from one state to the
+      next. The values are recomputed from scratch every
+      MAX_INCREMENTAL_SOLVES solves to avoid accumulating rounding errors.
+    */
+    bool reduced_costs_are_valid;
+    bool values_are_valid;
+    std::vector<int> changed_bound_variables;
+    int num_incremental_solves;
+
+    // Scratch space for the dual simplex method.
+    std::vector<double> pivot_row;
+    std::vector<double> pivot_column;
+    std::vector<double> tau;
+    std::vector<double> alphas;
+    std::vector<int> candidates;
+
+    SolutionStatus solution_status;
+    long long num_iterations;
+    int num_solves;
+    int num_refactorizations;
+
+    int get_num_rows() const;
+    int get_num_total_variables() const;
+    double get_cost(int var) const;
+    double get_nonbasic_value(int var) const;
+    VariableStatus get_nonbasic_status(int var, double value) const;
+
+    void load_column(int var, std::vector<double> &column) const;
+    double compute_dot_product(int var, const std::vector<double> &row) const;
+    void ftran(std::vector<double> &vec) const;
+    void btran(std::vector<double> &vec) const;
+    void add_eta(int position, const std::vector<double> &column);
+    void refactor();
+
+    void compute_primal_values();
+    void compute_reduced_costs();
+    bool set_dual_feasible_status(int var, double artificial_bound);
+    bool make_dual_feasible(double artificial_bound);
+    bool update_changed_variables();
+    int choose_leaving_position() const;
+    SimplexResult run_dual_simplex();
+    SolutionStatus check_feasibility();
+    SolutionStatus solve_from_scratch();
+    void invalidate_solution();
+public:
+    BuiltinSolverInterface();
+
+    virtual void load_problem(const LinearProgram &lp) override;
+    virtual void add_temporary_constraints(const named_vector::NamedVector<LPConstraint> &constraints) override;
+    virtual void clear_temporary_constraints() override;
+    virtual double get_infinity() const override;
+
+    virtual void set_objective_coefficients(const std::vector<double> &coefficients) override;
+    virtual void set_objective_coefficient(int index, double coefficient) override;
+    virtual void set_constraint_lower_bound(int index, double bound) override;
+    virtual void set_constraint_upper_bound(int index, double bound) override;
+    virtual void set_variable_lower_bound(int index, double bound) override;
+    virtual void set_variable_upper_bound(int index, double bound) override;
+
+    virtual void set_mip_gap(double gap) override;
+
+    virtual void solve() override;
+    virtual void write_lp(const std::string &filename) const override;
+    virtual void print_failure_analysis() const override;
+    virtual bool is_infeasible() const override;
+    virtual bool is_unbounded() const override;
+
+    virtual bool has_optimal_solution() const override;
+
+    virtual double get_objective_value() const override;
+
+    virtual std::vector<double> extract_solution() const override;
+    virtual LPBasis get_basis() const override;
+    virtual void set_basis(const LPBasis &basis) override;
+
+    virtual int get_num_variables() const override;
+    virtual int get_num_constraints() const override;
+    virtual bool has_temporary_constraints() const override;
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -577,6 +577,34 @@ vector<double> CplexSolverInterface::extract_solution() const {
     return solution;
 }
 
+LPBasis CplexSolverInterface::get_basis() const {
+    LPBasis basis;
+    if (is_mip || is_trivially_unsolvable()) {
+        return basis;
+    }
+    vector<int> column_status(get_num_variables());
+    vector<int> row_status(get_num_constraints());
+    CPX_CALL(CPXgetbase, env, problem, column_status.data(), row_status.data());
+    basis.variable_status.assign(column_status.begin(), column_status.end());
+    basis.constraint_status.assign(
+        row_status.begin(), row_status.begin() + num_permanent_constraints);
+    return basis;
+}
+
+void CplexSolverInterface::set_basis(const LPBasis &basis) {
+    if (is_mip || basis.empty()) {
+        return;
+    }
+    assert(static_cast<int>(basis.variable_status.size()) == get_num_variables());
+    assert(static_cast<int>(basis.constraint_status.size()) == num_permanent_constraints);
+    vector<int> column_status(
+        basis.variable_status.begin(), basis.variable_status.end());
+    vector<int> row_status(
+        basis.constraint_status.begin(), basis.constraint_status.end());
+    row_status.resize(get_num_constraints(), CPX_BASIC);
+    CPX_CALL(CPXcopybase, env, problem, column_status.data(), row_status.data());
+}
+
 int CplexSolverInterface::get_num_variables() const {
     return CPXgetnumcols(env, problem);
 }
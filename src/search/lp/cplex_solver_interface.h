@@ -219,6 +219,8 @@ public:
     virtual bool has_optimal_solution() const override;
     virtual double get_objective_value() const override;
     virtual std::vector<double> extract_solution() const override;
+    virtual LPBasis get_basis() const override;
+    virtual void set_basis(const LPBasis &basis) override;
     virtual int get_num_variables() const override;
     virtual int get_num_constraints() const override;
     virtual bool has_temporary_constraints() const override;
@@ -1,5 +1,6 @@
 #include "lp_solver.h"
 
+#include "builtin_solver_interface.h"
 #include "cplex_solver_interface.h"
 #include "soplex_solver_interface.h"
 
@@ -16,8 +17,9 @@ void add_lp_solver_option_to_feature(plugins::Feature &feature) {
 
     feature.document_note(
         "Note",
-        "to use an LP solver, you must build the planner with LP support. "
-        "See LPBuildInstructions.");
+        "to use CPLEX or SoPlex, you must build the planner with LP support. "
+        "See LPBuildInstructions. The builtin solver is always available "
+        "but is only suited for LPs of small to medium size.");
 }
 
 LPConstraint::LPConstraint(double lower_bound, double upper_bound)
@@ -125,6 +127,9 @@ LPSolver::LPSolver(LPSolverType solver_type) {
         missing_solver = "SoPlex";
 #endif
         break;
+    case LPSolverType::BUILTIN:
+        pimpl = make_unique<BuiltinSolverInterface>();
+        break;
     default:
         ABORT("Unknown LP solver type.");
     }
@@ -176,7 +181,7 @@ void LPSolver::set_variable_lower_bound(int index, double bound) {
 }
 
 void LPSolver::set_variable_upper_bound(int index, double bound) {
-    pimpl->set_constraint_upper_bound(index, bound);
+    pimpl->set_variable_upper_bound(index, bound);
 }
 
 void LPSolver::set_mip_gap(double gap) {
@@ -215,6 +220,14 @@ vector<double> LPSolver::extract_solution() const {
     return pimpl->extract_solution();
 }
 
+LPBasis LPSolver::get_basis() const {
+    return pimpl->get_basis();
+}
+
+void LPSolver::set_basis(const LPBasis &basis) {
+    pimpl->set_basis(basis);
+}
+
 int LPSolver::get_num_variables() const {
     return pimpl->get_num_variables();
 }
@@ -233,6 +246,8 @@ void LPSolver::print_statistics() const {
 
 static plugins::TypedEnumPlugin<LPSolverType> _enum_plugin({
         {"cplex", "commercial solver by IBM"},
-        {"soplex", "open source solver by ZIB"}
+        {"soplex", "open source solver by ZIB"},
+        {"builtin", "dual simplex solver that is part of the planner and "
+         "needs no external library"}
     });
 }
@@ -16,7 +16,7 @@ class Feature;
 
 namespace lp {
 enum class LPSolverType {
-    CPLEX, SOPLEX
+    CPLEX, SOPLEX, BUILTIN
 };
 
 enum class LPObjectiveSense {
@@ -144,6 +144,18 @@ public:
     */
     std::vector<double> extract_solution() const;
 
+    /*
+      Return the basis of the solution found after solving an LP, see
+      SolverInterface::get_basis().
+    */
+    LPBasis get_basis() const;
+
+    /*
+      Warm-start the next call to solve() from the given basis, see
+      SolverInterface::set_basis().
+    */
+    void set_basis(const LPBasis &basis);
+
     int get_num_variables() const;
     int get_num_constraints() const;
     int has_temporary_constraints() const;
@@ -1,6 +1,7 @@
 #ifndef LP_SOLVER_INTERFACE_H
 #define LP_SOLVER_INTERFACE_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,22 @@ namespace lp {
 class LinearProgram;
 class LPConstraint;
 
+/*
+  Basis of an LP with one status per variable and one per permanent
+  constraint in the encoding of the solver that created it. Bases can be
+  used to warm-start the solver on a similar LP, e.g., the LP of a
+  successor state. All solvers use small status codes, so we store them
+  in single bytes.
+*/
+struct LPBasis {
+    std::vector<std::int8_t> variable_status;
+    std::vector<std::int8_t> constraint_status;
+
+    bool empty() const {
+        return variable_status.empty();
+    }
+};
+
 class SolverInterface {
 public:
     virtual ~SolverInterface() = default;
@@ -61,6 +78,23 @@ public:
     */
     virtual std::vector<double> extract_solution() const = 0;
 
+    /*
+      Return the basis of the solution found after solving an LP. The
+      basis only covers the variables and the permanent constraints.
+      The LP has to be solved with a call to solve() and has to have an optimal
+      solution before calling this method. Solvers that cannot provide a
+      basis (e.g., for MIPs) return an empty basis.
+    */
+    virtual LPBasis get_basis() const = 0;
+
+    /*
+      Start the next call to solve() from the given basis, which must have
+      been returned by get_basis() for an LP with the same variables and
+      permanent constraints. Temporary constraints start with their slack
+      variables in the basis. Empty bases are ignored.
+    */
+    virtual void set_basis(const LPBasis &basis) = 0;
+
     virtual int get_num_variables() const = 0;
     virtual int get_num_constraints() const = 0;
     virtual bool has_temporary_constraints() const = 0;
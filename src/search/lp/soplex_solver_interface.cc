@@ -107,11 +107,11 @@ void SoPlexSolverInterface::set_constraint_upper_bound(int index, double bound)
 }
 
 void SoPlexSolverInterface::set_variable_lower_bound(int index, double bound) {
-    soplex.changeUpperReal(index, bound);
+    soplex.changeLowerReal(index, bound);
 }
 
 void SoPlexSolverInterface::set_variable_upper_bound(int index, double bound) {
-    soplex.changeLowerReal(index, bound);
+    soplex.changeUpperReal(index, bound);
 }
 
 void SoPlexSolverInterface::set_mip_gap(double /*gap*/) {
@@ -212,6 +212,38 @@ vector<double> SoPlexSolverInterface::extract_solution() const {
     return sol.vec();
 }
 
+LPBasis SoPlexSolverInterface::get_basis() const {
+    vector<SPxSolverBase<double>::VarStatus> row_status(get_num_constraints());
+    vector<SPxSolverBase<double>::VarStatus> column_status(get_num_variables());
+    soplex.getBasis(row_status.data(), column_status.data());
+    LPBasis basis;
+    basis.variable_status.assign(column_status.begin(), column_status.end());
+    basis.constraint_status.assign(
+        row_status.begin(), row_status.begin() + num_permanent_constraints);
+    return basis;
+}
+
+void SoPlexSolverInterface::set_basis(const LPBasis &basis) {
+    if (basis.empty()) {
+        return;
+    }
+    assert(static_cast<int>(basis.variable_status.size()) == get_num_variables());
+    assert(static_cast<int>(basis.constraint_status.size()) == num_permanent_constraints);
+    vector<SPxSolverBase<double>::VarStatus> row_status(
+        get_num_constraints(), SPxSolverBase<double>::BASIC);
+    vector<SPxSolverBase<double>::VarStatus> column_status;
+    column_status.reserve(basis.variable_status.size());
+    for (int status : basis.variable_status) {
+        column_status.push_back(
+            static_cast<SPxSolverBase<double>::VarStatus>(status));
+    }
+    for (int i = 0; i < num_permanent_constraints; ++i) {
+        row_status[i] = static_cast<SPxSolverBase<double>::VarStatus>(
+            basis.constraint_status[i]);
+    }
+    soplex.setBasis(row_status.data(), column_status.data());
+}
+
 int SoPlexSolverInterface::get_num_variables() const {
     return soplex.numCols();
 }
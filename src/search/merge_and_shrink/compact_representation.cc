@@ -0,0 +1,349 @@
+#include "compact_representation.h"
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/memory.h"
+#include "../utils/memory_mapped_file.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace merge_and_shrink {
+/*
+  A block starts with a CompactHeader, followed by the domain sizes of all
+  variables (one uint32_t each), the root node IDs of all factors (one
+  uint32_t each), one CompactNode per node and the value and run start
+  arrays of the nodes. Every section starts at a multiple of 8 bytes.
+*/
+static const char MAGIC[8] = {'F', 'D', '-', 'M', 'A', 'S', '\0', '\0'};
+static const uint32_t VERSION = 1;
+static const uint32_t NO_CHILD = numeric_limits<uint32_t>::max();
+
+struct CompactHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_variables;
+    uint32_t num_factors;
+    uint32_t num_nodes;
+    uint64_t size;
+};
+
+struct CompactNode {
+    // Variable ID for leaves and ID of the left child for merge nodes.
+    uint32_t left;
+    // ID of the right child for merge nodes and NO_CHILD for leaves.
+    uint32_t right;
+    uint32_t num_columns;
+    uint32_t num_entries;
+    // Number of runs for run-length encoded tables and 0 otherwise.
+    uint32_t num_runs;
+    // Number of bytes per value (1, 2 or 4).
+    uint32_t value_width;
+    // Offsets from the start of the block.
+    uint64_t values_offset;
+    uint64_t run_starts_offset;
+};
+
+static size_t align(size_t offset) {
+    return (offset + 7) / 8 * 8;
+}
+
+/*
+  We store value + 1, so that PRUNED_STATE becomes 0, and use the largest
+  code of the chosen width for INF.
+*/
+static uint32_t get_inf_code(int width) {
+    return (width == 4) ? numeric_limits<uint32_t>::max()
+           : (uint32_t(1) << (8 * width)) - 1;
+}
+
+static uint32_t encode(int value, int width) {
+    return (value == INF) ? get_inf_code(width) : static_cast<uint32_t>(value + 1);
+}
+
+static int decode(uint32_t code, int width) {
+    return (code == get_inf_code(width)) ? INF : static_cast<int>(code) - 1;
+}
+
+static int compute_value_width(const vector<int> &values) {
+    uint32_t max_code = 0;
+    for (int value : values) {
+        if (value != INF) {
+            max_code = max(max_code, encode(value, 4));
+        }
+    }
+    for (int width : {1, 2}) {
+        if (max_code < get_inf_code(width)) {
+            return width;
+        }
+    }
+    return 4;
+}
+
+static void write_code(char *values, size_t index, int width, uint32_t code) {
+    if (width == 1) {
+        reinterpret_cast<uint8_t *>(values)[index] = code;
+    } else if (width == 2) {
+        reinterpret_cast<uint16_t *>(values)[index] = code;
+    } else {
+        reinterpret_cast<uint32_t *>(values)[index] = code;
+    }
+}
+
+static uint32_t read_code(const char *values, size_t index, int width) {
+    if (width == 1) {
+        return reinterpret_cast<const uint8_t *>(values)[index];
+    } else if (width == 2) {
+        return reinterpret_cast<const uint16_t *>(values)[index];
+    } else {
+        return reinterpret_cast<const uint32_t *>(values)[index];
+    }
+}
+
+int CompactRepresentationBuilder::add_leaf(
+    int var_id, const vector<int> &lookup_table) {
+    nodes.push_back({var_id, -1, static_cast<int>(lookup_table.size()), lookup_table});
+    return nodes.size() - 1;
+}
+
+int CompactRepresentationBuilder::add_merge(
+    int left_child, int right_child, const vector<vector<int>> &lookup_table) {
+    assert(left_child < static_cast<int>(nodes.size()));
+    assert(right_child < static_cast<int>(nodes.size()));
+    int num_columns = lookup_table.empty() ? 0 : lookup_table[0].size();
+    vector<int> values;
+    values.reserve(lookup_table.size() * num_columns);
+    for (const vector<int> &row : lookup_table) {
+        assert(static_cast<int>(row.size()) == num_columns);
+        values.insert(values.end(), row.begin(), row.end());
+    }
+    nodes.push_back({left_child, right_child, num_columns, move(values)});
+    return nodes.size() - 1;
+}
+
+void CompactRepresentationBuilder::add_factor(int root) {
+    assert(root < static_cast<int>(nodes.size()));
+    factor_roots.push_back(root);
+}
+
+vector<char> CompactRepresentationBuilder::serialize(
+    const TaskProxy &task_proxy) const {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_nodes = nodes.size();
+
+    // Choose the encoding of each node and compute the layout.
+    vector<CompactNode> compact_nodes(num_nodes);
+    vector<vector<uint32_t>> run_starts(num_nodes);
+    size_t offset = align(sizeof(CompactHeader));
+    offset = align(offset + variables.size() * sizeof(uint32_t));
+    offset = align(offset + factor_roots.size() * sizeof(uint32_t));
+    offset += num_nodes * sizeof(CompactNode);
+    for (int node_id = 0; node_id < num_nodes; ++node_id) {
+        const NodeData &node = nodes[node_id];
+        const vector<int> &values = node.values;
+        CompactNode &compact_node = compact_nodes[node_id];
+        compact_node.left = node.left;
+        compact_node.right = (node.right == -1) ? NO_CHILD : node.right;
+        compact_node.num_columns = node.num_columns;
+        compact_node.num_entries = values.size();
+        int width = compute_value_width(values);
+        compact_node.value_width = width;
+
+        vector<uint32_t> &starts = run_starts[node_id];
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i == 0 || values[i] != values[i - 1]) {
+                starts.push_back(i);
+            }
+        }
+        size_t dense_size = values.size() * width;
+        size_t run_length_size = starts.size() * (sizeof(uint32_t) + width);
+        if (2 * run_length_size <= dense_size) {
+            compact_node.num_runs = starts.size();
+            compact_node.run_starts_offset = align(offset);
+            offset = compact_node.run_starts_offset + starts.size() * sizeof(uint32_t);
+        } else {
+            compact_node.num_runs = 0;
+            compact_node.run_starts_offset = 0;
+            starts.clear();
+        }
+        compact_node.values_offset = align(offset);
+        size_t num_codes = compact_node.num_runs ? compact_node.num_runs : values.size();
+        offset = compact_node.values_offset + num_codes * width;
+    }
+    size_t size = align(offset);
+
+    vector<char> buffer(size, 0);
+    char *data = buffer.data();
+    CompactHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.num_variables = variables.size();
+    header.num_factors = factor_roots.size();
+    header.num_nodes = num_nodes;
+    header.size = size;
+    memcpy(data, &header, sizeof(header));
+    offset = align(sizeof(CompactHeader));
+    for (VariableProxy var : variables) {
+        reinterpret_cast<uint32_t *>(data + offset)[var.get_id()] = var.get_domain_size();
+    }
+    offset = align(offset + variables.size() * sizeof(uint32_t));
+    copy(factor_roots.begin(), factor_roots.end(),
+         reinterpret_cast<uint32_t *>(data + offset));
+    offset = align(offset + factor_roots.size() * sizeof(uint32_t));
+    memcpy(data + offset, compact_nodes.data(), num_nodes * sizeof(CompactNode));
+
+    for (int node_id = 0; node_id < num_nodes; ++node_id) {
+        const CompactNode &compact_node = compact_nodes[node_id];
+        const vector<int> &values = nodes[node_id].values;
+        const vector<uint32_t> &starts = run_starts[node_id];
+        int width = compact_node.value_width;
+        char *codes = data + compact_node.values_offset;
+        if (compact_node.num_runs) {
+            copy(starts.begin(), starts.end(),
+                 reinterpret_cast<uint32_t *>(data + compact_node.run_starts_offset));
+            for (size_t run = 0; run < starts.size(); ++run) {
+                write_code(codes, run, width, encode(values[starts[run]], width));
+            }
+        } else {
+            for (size_t i = 0; i < values.size(); ++i) {
+                write_code(codes, i, width, encode(values[i], width));
+            }
+        }
+    }
+    return buffer;
+}
+
+
+CompactRepresentation::CompactRepresentation(vector<char> &&buffer_)
+    : buffer(move(buffer_)),
+      data(buffer.data()),
+      size(buffer.size()) {
+    initialize("merge-and-shrink representation");
+}
+
+CompactRepresentation::CompactRepresentation(const string &filename)
+    : file(utils::make_unique_ptr<utils::MemoryMappedFile>(filename)),
+      data(file->get_data()),
+      size(file->get_size()) {
+    initialize(filename);
+}
+
+CompactRepresentation::~CompactRepresentation() {
+}
+
+void CompactRepresentation::initialize(const string &source) {
+    auto check = [&source](bool condition) {
+            if (!condition) {
+                cerr << "Invalid merge-and-shrink representation: "
+                     << source << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+        };
+    check(size >= sizeof(CompactHeader));
+    const CompactHeader &header = *reinterpret_cast<const CompactHeader *>(data);
+    check(equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic));
+    check(header.version == VERSION);
+    check(header.size == size);
+
+    size_t offset = align(sizeof(CompactHeader));
+    offset = align(offset + header.num_variables * sizeof(uint32_t));
+    factor_roots = reinterpret_cast<const uint32_t *>(data + offset);
+    offset = align(offset + header.num_factors * sizeof(uint32_t));
+    nodes = reinterpret_cast<const CompactNode *>(data + offset);
+    offset += header.num_nodes * sizeof(CompactNode);
+    check(offset <= size);
+    num_factors = header.num_factors;
+
+    for (uint32_t node_id = 0; node_id < header.num_nodes; ++node_id) {
+        const CompactNode &node = nodes[node_id];
+        if (node.right == NO_CHILD) {
+            check(node.left < header.num_variables);
+        } else {
+            check(node.left < node_id && node.right < node_id);
+        }
+        check(node.value_width == 1 || node.value_width == 2 ||
+              node.value_width == 4);
+        size_t num_codes = node.num_runs ? node.num_runs : node.num_entries;
+        check(node.values_offset + num_codes * node.value_width <= size);
+        check(node.run_starts_offset + node.num_runs * sizeof(uint32_t) <= size);
+    }
+    for (int factor = 0; factor < num_factors; ++factor) {
+        check(factor_roots[factor] < header.num_nodes);
+    }
+}
+
+void CompactRepresentation::verify_task(const TaskProxy &task_proxy) const {
+    const CompactHeader &header = *reinterpret_cast<const CompactHeader *>(data);
+    const uint32_t *domain_sizes =
+        reinterpret_cast<const uint32_t *>(data + align(sizeof(CompactHeader)));
+    VariablesProxy variables = task_proxy.get_variables();
+    bool matches = (header.num_variables == variables.size());
+    for (size_t var = 0; matches && var < variables.size(); ++var) {
+        matches = (static_cast<int>(domain_sizes[var]) ==
+                   variables[var].get_domain_size());
+    }
+    if (!matches) {
+        cerr << "The merge-and-shrink representation was computed for a "
+             << "task with different variables." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void CompactRepresentation::save(const string &filename) const {
+    string tmp_filename = filename + ".tmp";
+    {
+        ofstream file(tmp_filename, ios::binary);
+        if (!file.write(data, size)) {
+            cerr << "Failed to write file: " << tmp_filename << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+    if (rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        cerr << "Failed to rename " << tmp_filename << " to "
+             << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+int CompactRepresentation::lookup(const CompactNode &node, size_t index) const {
+    assert(index < node.num_entries);
+    const char *codes = data + node.values_offset;
+    if (node.num_runs) {
+        const uint32_t *run_starts =
+            reinterpret_cast<const uint32_t *>(data + node.run_starts_offset);
+        index = upper_bound(run_starts, run_starts + node.num_runs, index)
+            - run_starts - 1;
+    }
+    return decode(read_code(codes, index, node.value_width), node.value_width);
+}
+
+int CompactRepresentation::get_node_value(int node_id, const State &state) const {
+    const CompactNode &node = nodes[node_id];
+    size_t index;
+    if (node.right == NO_CHILD) {
+        index = state[node.left].get_value();
+    } else {
+        int value1 = get_node_value(node.left, state);
+        int value2 = get_node_value(node.right, state);
+        if (value1 == PRUNED_STATE || value2 == PRUNED_STATE)
+            return PRUNED_STATE;
+        index = static_cast<size_t>(value1) * node.num_columns + value2;
+    }
+    return lookup(node, index);
+}
+
+int CompactRepresentation::get_value(int factor, const State &state) const {
+    assert(factor >= 0 && factor < num_factors);
+    return get_node_value(factor_roots[factor], state);
+}
+}
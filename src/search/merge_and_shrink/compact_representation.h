@@ -0,0 +1,106 @@
+#ifndef MERGE_AND_SHRINK_COMPACT_REPRESENTATION_H
+#define MERGE_AND_SHRINK_COMPACT_REPRESENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class State;
+class TaskProxy;
+
+namespace utils {
+class MemoryMappedFile;
+}
+
+namespace merge_and_shrink {
+struct CompactNode;
+
+/*
+  Collect the lookup tables of merge-and-shrink representations and
+  serialize them into the format read by CompactRepresentation. Nodes
+  must be added bottom-up, i.e., children before their parents.
+*/
+class CompactRepresentationBuilder {
+    struct NodeData {
+        int left;
+        int right;
+        int num_columns;
+        std::vector<int> values;
+    };
+    std::vector<NodeData> nodes;
+    std::vector<int> factor_roots;
+public:
+    // Return the ID of the new node.
+    int add_leaf(int var_id, const std::vector<int> &lookup_table);
+    int add_merge(
+        int left_child, int right_child,
+        const std::vector<std::vector<int>> &lookup_table);
+    void add_factor(int root);
+
+    std::vector<char> serialize(const TaskProxy &task_proxy) const;
+};
+
+/*
+  Read-only representation of the final factors of a merge-and-shrink
+  heuristic in a single block of memory. The block has the same layout in
+  memory and on disk, so we can save it and map it into memory again
+  without parsing it. Processes that map the same file share its memory.
+
+  For each node of the merge-and-shrink representations, we store its
+  lookup table (flattened row-wise for merge nodes) with the smallest
+  integer width (1, 2 or 4 bytes) that fits all values. Tables with few
+  runs of equal values, e.g., tables with many pruned entries, are
+  run-length encoded instead and looked up by binary search.
+
+  The format uses the native byte order, so files can only be shared
+  between machines with the same endianness.
+*/
+class CompactRepresentation {
+    std::unique_ptr<utils::MemoryMappedFile> file;
+    std::vector<char> buffer;
+    const char *data;
+    std::size_t size;
+    int num_factors;
+    const std::uint32_t *factor_roots;
+    const CompactNode *nodes;
+
+    void initialize(const std::string &source);
+    int lookup(const CompactNode &node, std::size_t index) const;
+    int get_node_value(int node_id, const State &state) const;
+public:
+    explicit CompactRepresentation(std::vector<char> &&buffer);
+    // Map the given file into memory.
+    explicit CompactRepresentation(const std::string &filename);
+    ~CompactRepresentation();
+
+    /*
+      Exit with SEARCH_INPUT_ERROR if the representation was computed for
+      a task with different variables.
+    */
+    void verify_task(const TaskProxy &task_proxy) const;
+
+    /*
+      Write the representation to a temporary file and rename it, so that
+      concurrent readers never see an incomplete file.
+    */
+    void save(const std::string &filename) const;
+
+    int get_num_factors() const {
+        return num_factors;
+    }
+
+    /*
+      Return the goal distance of the abstract state that the factor maps
+      the state to, or PRUNED_STATE if the state is pruned.
+    */
+    int get_value(int factor, const State &state) const;
+
+    std::size_t get_size_in_bytes() const {
+        return size;
+    }
+};
+}
+
+#endif
@@ -64,7 +64,8 @@ static void breadth_first_search(
 void Distances::compute_init_distances_unit_cost() {
     vector<vector<int>> forward_graph(get_num_states());
     for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        span<const Transition> transitions =
+            transition_system.get_transitions(local_label_info);
         for (const Transition &transition : transitions) {
             forward_graph[transition.src].push_back(transition.target);
         }
@@ -79,7 +80,8 @@ void Distances::compute_init_distances_unit_cost() {
 void Distances::compute_goal_distances_unit_cost() {
     vector<vector<int>> backward_graph(get_num_states());
     for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        span<const Transition> transitions =
+            transition_system.get_transitions(local_label_info);
         for (const Transition &transition : transitions) {
             backward_graph[transition.target].push_back(transition.src);
         }
@@ -123,7 +125,8 @@ static void dijkstra_search(
 void Distances::compute_init_distances_general_cost() {
     vector<vector<pair<int, int>>> forward_graph(get_num_states());
     for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        span<const Transition> transitions =
+            transition_system.get_transitions(local_label_info);
         int cost = local_label_info.get_cost();
         for (const Transition &transition : transitions) {
             forward_graph[transition.src].push_back(
@@ -142,7 +145,8 @@ void Distances::compute_init_distances_general_cost() {
 void Distances::compute_goal_distances_general_cost() {
     vector<vector<pair<int, int>>> backward_graph(get_num_states());
     for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        span<const Transition> transitions =
+            transition_system.get_transitions(local_label_info);
         int cost = local_label_info.get_cost();
         for (const Transition &transition : transitions) {
             backward_graph[transition.target].push_back(
@@ -9,6 +9,7 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <cassert>
@@ -43,6 +44,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     vector<unique_ptr<Distances>> &&distances,
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log)
     : labels(move(labels)),
       transition_systems(move(transition_systems)),
@@ -51,11 +53,17 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       compute_init_distances(compute_init_distances),
       compute_goal_distances(compute_goal_distances),
       num_active_entries(this->transition_systems.size()) {
+    // Logging is not thread-safe, so only the sequential version logs.
+    utils::LogProxy silent_log = utils::get_silent_log();
+    utils::LogProxy &factor_log = (num_threads == 1) ? log : silent_log;
+    utils::parallel_for(
+        num_threads, this->transition_systems.size(), [&](int index) {
+            if (compute_init_distances || compute_goal_distances) {
+                this->distances[index]->compute_distances(
+                    compute_init_distances, compute_goal_distances, factor_log);
+            }
+        });
     for (size_t index = 0; index < this->transition_systems.size(); ++index) {
-        if (compute_init_distances || compute_goal_distances) {
-            this->distances[index]->compute_distances(
-                compute_init_distances, compute_goal_distances, log);
-        }
         assert(is_component_valid(index));
     }
 }
@@ -161,6 +169,7 @@ bool FactoredTransitionSystem::apply_abstraction(
 int FactoredTransitionSystem::merge(
     int index1,
     int index2,
+    int num_threads,
     utils::LogProxy &log) {
     assert(is_component_valid(index1));
     assert(is_component_valid(index2));
@@ -169,6 +178,7 @@ int FactoredTransitionSystem::merge(
             *labels,
             *transition_systems[index1],
             *transition_systems[index2],
+            num_threads,
             log));
     distances[index1] = nullptr;
     distances[index2] = nullptr;
@@ -91,6 +91,7 @@ public:
         std::vector<std::unique_ptr<Distances>> &&distances,
         bool compute_init_distances,
         bool compute_goal_distances,
+        int num_threads,
         utils::LogProxy &log);
     FactoredTransitionSystem(FactoredTransitionSystem &&other);
     ~FactoredTransitionSystem();
@@ -128,11 +129,13 @@ public:
         utils::LogProxy &log);
 
     /*
-      Merge the two factors at index1 and index2.
+      Merge the two factors at index1 and index2, using up to num_threads
+      threads for computing the product.
     */
     int merge(
         int index1,
         int index2,
+        int num_threads,
         utils::LogProxy &log);
 
     /*
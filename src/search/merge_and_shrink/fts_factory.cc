@@ -31,6 +31,7 @@ class FTSFactory {
 
         vector<int> label_to_local_label;
         vector<LocalLabelInfo> local_label_infos;
+        vector<Transition> transitions;
         vector<bool> relevant_labels;
         int num_states;
         vector<bool> goal_states;
@@ -40,6 +41,7 @@ class FTSFactory {
               incorporated_variables(move(other.incorporated_variables)),
               label_to_local_label(move(other.label_to_local_label)),
               local_label_infos(move(other.local_label_infos)),
+              transitions(move(other.transitions)),
               relevant_labels(move(other.relevant_labels)),
               num_states(other.num_states),
               goal_states(move(other.goal_states)),
@@ -90,6 +92,7 @@ public:
     FactoredTransitionSystem create(
         bool compute_init_distances,
         bool compute_goal_distances,
+        int num_threads,
         utils::LogProxy &log);
 };
 
@@ -303,14 +306,17 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
             assert(utils::is_sorted_unique(transitions));
         }
 
-        vector<int> &label_to_local_label =
-            transition_system_data_by_var[var_id].label_to_local_label;
-        vector<LocalLabelInfo> &local_label_infos = transition_system_data_by_var[var_id].local_label_infos;
+        TransitionSystemData &ts_data = transition_system_data_by_var[var_id];
+        vector<int> &label_to_local_label = ts_data.label_to_local_label;
+        vector<LocalLabelInfo> &local_label_infos = ts_data.local_label_infos;
         bool found_locally_equivalent_label_group = false;
         for (size_t local_label = 0; local_label < local_label_infos.size(); ++local_label) {
             LocalLabelInfo &local_label_info = local_label_infos[local_label];
-            const vector<Transition> &local_label_transitions = local_label_info.get_transitions();
-            if (transitions == local_label_transitions) {
+            auto local_label_transitions =
+                ts_data.transitions.begin() + local_label_info.get_transitions_begin();
+            if (equal(transitions.begin(), transitions.end(),
+                      local_label_transitions,
+                      local_label_transitions + local_label_info.get_num_transitions())) {
                 assert(label_to_local_label[label] == -1);
                 label_to_local_label[label] = local_label;
                 local_label_info.add_label(label, label_cost);
@@ -322,7 +328,11 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
         if (!found_locally_equivalent_label_group) {
             int new_local_label = local_label_infos.size();
             LabelGroup label_group = {label};
-            local_label_infos.emplace_back(move(label_group), move(transitions), label_cost);
+            size_t transitions_begin = ts_data.transitions.size();
+            ts_data.transitions.insert(
+                ts_data.transitions.end(), transitions.begin(), transitions.end());
+            local_label_infos.emplace_back(
+                move(label_group), transitions_begin, transitions.size(), label_cost);
             assert(label_to_local_label[label] == -1);
             label_to_local_label[label] = new_local_label;
         }
@@ -346,17 +356,16 @@ void FTSFactory::build_transitions_for_irrelevant_ops(
 
     TransitionSystemData &ts_data = transition_system_data_by_var[var_id];
     if (!irrelevant_labels.empty()) {
-        vector<Transition> transitions;
-        transitions.reserve(num_states);
+        size_t transitions_begin = ts_data.transitions.size();
         for (int state = 0; state < num_states; ++state)
-            transitions.emplace_back(state, state);
+            ts_data.transitions.emplace_back(state, state);
         int new_local_label = ts_data.local_label_infos.size();
         for (int label : irrelevant_labels) {
             assert(ts_data.label_to_local_label[label] == -1);
             ts_data.label_to_local_label[label] = new_local_label;
         }
         ts_data.local_label_infos.emplace_back(
-            move(irrelevant_labels), move(transitions), cost);
+            move(irrelevant_labels), transitions_begin, num_states, cost);
     }
 }
 
@@ -394,6 +403,7 @@ vector<unique_ptr<TransitionSystem>> FTSFactory::create_transition_systems(const
                              labels,
                              move(ts_data.label_to_local_label),
                              move(ts_data.local_label_infos),
+                             move(ts_data.transitions),
                              ts_data.num_states,
                              move(ts_data.goal_states),
                              ts_data.init_state
@@ -439,6 +449,7 @@ vector<unique_ptr<Distances>> FTSFactory::create_distances(
 FactoredTransitionSystem FTSFactory::create(
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log) {
     if (log.is_at_least_normal()) {
         log << "Building atomic transition systems... " << endl;
@@ -462,6 +473,7 @@ FactoredTransitionSystem FTSFactory::create(
         move(distances),
         compute_init_distances,
         compute_goal_distances,
+        num_threads,
         log);
 }
 
@@ -469,10 +481,12 @@ FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log) {
     return FTSFactory(task_proxy).create(
         compute_init_distances,
         compute_goal_distances,
+        num_threads,
         log);
 }
 }
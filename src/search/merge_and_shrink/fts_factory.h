@@ -9,6 +9,9 @@
   planning tasks to the concepts on which merge-and-shrink abstractions
   are based (transition systems, labels, etc.). The "internal" classes of
   merge-and-shrink should not need to know about planning task concepts.
+
+  The distances of the atomic factors are computed with up to num_threads
+  threads.
 */
 
 class TaskProxy;
@@ -24,6 +27,7 @@ extern FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     bool compute_init_distances,
     bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log);
 }
 
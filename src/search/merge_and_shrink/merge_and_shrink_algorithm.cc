@@ -18,9 +18,12 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -48,6 +51,7 @@ MergeAndShrinkAlgorithm::MergeAndShrinkAlgorithm(const plugins::Options &opts) :
     prune_irrelevant_states(opts.get<bool>("prune_irrelevant_states")),
     log(utils::get_log_from_options(opts)),
     main_loop_max_time(opts.get<double>("main_loop_max_time")),
+    num_threads(opts.get<int>("threads")),
     starting_peak_memory(0) {
     assert(max_states_before_merge > 0);
     assert(max_states >= max_states_before_merge);
@@ -96,6 +100,7 @@ void MergeAndShrinkAlgorithm::dump_options() const {
         log << endl;
 
         log << "Main loop max time in seconds: " << main_loop_max_time << endl;
+        log << "Threads: " << num_threads << endl;
         log << endl;
     }
 }
@@ -161,6 +166,45 @@ bool MergeAndShrinkAlgorithm::ran_out_of_time(
     return false;
 }
 
+/*
+  Prune all atomic factors according to the chosen options and return true
+  iff any factor was pruned. Stop early and set unsolvable if one factor is
+  unsolvable.
+
+  TODO: think about if we can prune already while creating the atomic FTS.
+*/
+bool MergeAndShrinkAlgorithm::prune_atomic_factors(
+    FactoredTransitionSystem &fts, bool &unsolvable) {
+    // Logging is not thread-safe, so only the sequential version logs.
+    utils::LogProxy silent_log = utils::get_silent_log();
+    utils::LogProxy &factor_log = (num_threads == 1) ? log : silent_log;
+    vector<int> pruned_factors(fts.get_size(), 0);
+    atomic<bool> found_unsolvable_factor(false);
+    utils::parallel_for(num_threads, fts.get_size(), [&](int index) {
+            assert(fts.is_active(index));
+            if (found_unsolvable_factor) {
+                return;
+            }
+            if (prune_unreachable_states || prune_irrelevant_states) {
+                pruned_factors[index] = prune_step(
+                    fts,
+                    index,
+                    prune_unreachable_states,
+                    prune_irrelevant_states,
+                    factor_log);
+            }
+            if (!fts.is_factor_solvable(index)) {
+                found_unsolvable_factor = true;
+            }
+        });
+    if (found_unsolvable_factor) {
+        log << "Atomic FTS is unsolvable, stopping computation." << endl;
+        unsolvable = true;
+    }
+    return any_of(pruned_factors.begin(), pruned_factors.end(),
+                  [](int pruned) {return pruned;});
+}
+
 void MergeAndShrinkAlgorithm::main_loop(
     FactoredTransitionSystem &fts,
     const TaskProxy &task_proxy) {
@@ -235,6 +279,7 @@ void MergeAndShrinkAlgorithm::main_loop(
             max_states_before_merge,
             shrink_threshold_before_merge,
             *shrink_strategy,
+            num_threads,
             log);
         if (log.is_at_least_normal() && shrunk) {
             log_main_loop_progress("after shrinking");
@@ -257,7 +302,8 @@ void MergeAndShrinkAlgorithm::main_loop(
         }
 
         // Merging
-        int merged_index = fts.merge(merge_index1, merge_index2, log);
+        int merged_index = fts.merge(
+            merge_index1, merge_index2, num_threads, log);
         int abs_size = fts.get_transition_system(merged_index).get_size();
         if (abs_size > maximum_intermediate_size) {
             maximum_intermediate_size = abs_size;
@@ -356,36 +402,14 @@ FactoredTransitionSystem MergeAndShrinkAlgorithm::build_factored_transition_syst
             task_proxy,
             compute_init_distances,
             compute_goal_distances,
+            num_threads,
             log);
     if (log.is_at_least_normal()) {
         log_progress(timer, "after computation of atomic factors", log);
     }
 
-    /*
-      Prune all atomic factors according to the chosen options. Stop early if
-      one factor is unsolvable.
-
-      TODO: think about if we can prune already while creating the atomic FTS.
-    */
-    bool pruned = false;
     bool unsolvable = false;
-    for (int index = 0; index < fts.get_size(); ++index) {
-        assert(fts.is_active(index));
-        if (prune_unreachable_states || prune_irrelevant_states) {
-            bool pruned_factor = prune_step(
-                fts,
-                index,
-                prune_unreachable_states,
-                prune_irrelevant_states,
-                log);
-            pruned = pruned || pruned_factor;
-        }
-        if (!fts.is_factor_solvable(index)) {
-            log << "Atomic FTS is unsolvable, stopping computation." << endl;
-            unsolvable = true;
-            break;
-        }
-    }
+    bool pruned = prune_atomic_factors(fts, unsolvable);
     if (log.is_at_least_normal()) {
         if (pruned) {
             log_progress(timer, "after pruning atomic factors", log);
@@ -451,6 +475,17 @@ void add_merge_and_shrink_algorithm_options_to_feature(plugins::Feature &feature
         "transformation is runtime-intense.",
         "infinity",
         Bounds("0.0", "infinity"));
+
+    feature.add_option<int>(
+        "threads",
+        "Number of threads for computing the distances of the atomic "
+        "factors, for pruning atomic factors, for computing the "
+        "transitions of products and for refining bisimulations in "
+        "shrink_bisimulation. The merge-and-shrink transformations "
+        "themselves are still applied one after the other, so the result "
+        "is the same for all numbers of threads.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 void add_transition_system_size_limit_options_to_feature(plugins::Feature &feature) {
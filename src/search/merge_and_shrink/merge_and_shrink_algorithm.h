@@ -45,6 +45,7 @@ class MergeAndShrinkAlgorithm {
 
     mutable utils::LogProxy log;
     const double main_loop_max_time;
+    const int num_threads;
 
     long starting_peak_memory;
 
@@ -53,6 +54,7 @@ class MergeAndShrinkAlgorithm {
     void warn_on_unusual_options() const;
     bool ran_out_of_time(const utils::CountdownTimer &timer) const;
     void statistics(int maximum_intermediate_size) const;
+    bool prune_atomic_factors(FactoredTransitionSystem &fts, bool &unsolvable);
     void main_loop(
         FactoredTransitionSystem &fts,
         const TaskProxy &task_proxy);
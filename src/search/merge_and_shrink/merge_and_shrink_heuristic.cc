@@ -1,5 +1,6 @@
 #include "merge_and_shrink_heuristic.h"
 
+#include "compact_representation.h"
 #include "distances.h"
 #include "factored_transition_system.h"
 #include "merge_and_shrink_algorithm.h"
@@ -10,6 +11,7 @@
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/markup.h"
+#include "../utils/memory.h"
 #include "../utils/system.h"
 
 #include <cassert>
@@ -23,18 +25,41 @@ namespace merge_and_shrink {
 MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const plugins::Options &opts)
     : Heuristic(opts) {
     log << "Initializing merge-and-shrink heuristic..." << endl;
-    MergeAndShrinkAlgorithm algorithm(opts);
-    FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
-    extract_factors(fts);
+    if (opts.contains("file")) {
+        string filename = opts.get<string>("file");
+        log << "Loading merge-and-shrink representation from "
+            << filename << endl;
+        representation = utils::make_unique_ptr<CompactRepresentation>(filename);
+        representation->verify_task(task_proxy);
+    } else {
+        MergeAndShrinkAlgorithm algorithm(opts);
+        FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
+        CompactRepresentationBuilder builder;
+        extract_factors(fts, builder);
+        representation = utils::make_unique_ptr<CompactRepresentation>(
+            builder.serialize(task_proxy));
+        if (opts.contains("save_to_file")) {
+            string filename = opts.get<string>("save_to_file");
+            representation->save(filename);
+            log << "Saved merge-and-shrink representation to "
+                << filename << endl;
+        }
+    }
+    if (log.is_at_least_normal()) {
+        log << "Number of factors: " << representation->get_num_factors() << endl;
+        log << "Size of merge-and-shrink representation: "
+            << representation->get_size_in_bytes() / 1024 << " KB" << endl;
+    }
     log << "Done initializing merge-and-shrink heuristic." << endl << endl;
 }
 
 void MergeAndShrinkHeuristic::extract_factor(
-    FactoredTransitionSystem &fts, int index) {
+    FactoredTransitionSystem &fts, int index,
+    CompactRepresentationBuilder &builder) {
     /*
       Extract the factor at the given index from the given factored transition
-      system, compute goal distances if necessary and store the M&S
-      representation, which serves as the heuristic.
+      system, compute goal distances if necessary and add the M&S
+      representation, which serves as the heuristic, to the builder.
     */
     auto final_entry = fts.extract_factor(index);
     unique_ptr<MergeAndShrinkRepresentation> mas_representation = move(final_entry.first);
@@ -46,16 +71,16 @@ void MergeAndShrinkHeuristic::extract_factor(
     }
     assert(distances->are_goal_distances_computed());
     mas_representation->set_distances(*distances);
-    mas_representations.push_back(move(mas_representation));
+    builder.add_factor(mas_representation->add_to(builder));
 }
 
-bool MergeAndShrinkHeuristic::extract_unsolvable_factor(FactoredTransitionSystem &fts) {
+bool MergeAndShrinkHeuristic::extract_unsolvable_factor(
+    FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder) {
     /* Check if there is an unsolvable factor. If so, extract and store it and
        return true. Otherwise, return false. */
     for (int index : fts) {
         if (!fts.is_factor_solvable(index)) {
-            mas_representations.reserve(1);
-            extract_factor(fts, index);
+            extract_factor(fts, index, builder);
             if (log.is_at_least_normal()) {
                 log << fts.get_transition_system(index).tag()
                     << "use this unsolvable factor as heuristic."
@@ -67,7 +92,8 @@ bool MergeAndShrinkHeuristic::extract_unsolvable_factor(FactoredTransitionSystem
     return false;
 }
 
-void MergeAndShrinkHeuristic::extract_nontrivial_factors(FactoredTransitionSystem &fts) {
+void MergeAndShrinkHeuristic::extract_nontrivial_factors(
+    FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder) {
     // Iterate over remaining factors and extract and store the nontrivial ones.
     for (int index : fts) {
         if (fts.is_factor_trivial(index)) {
@@ -76,12 +102,13 @@ void MergeAndShrinkHeuristic::extract_nontrivial_factors(FactoredTransitionSyste
                     << "is trivial." << endl;
             }
         } else {
-            extract_factor(fts, index);
+            extract_factor(fts, index, builder);
         }
     }
 }
 
-void MergeAndShrinkHeuristic::extract_factors(FactoredTransitionSystem &fts) {
+void MergeAndShrinkHeuristic::extract_factors(
+    FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder) {
     /*
       TODO: This method has quite a bit of fiddling with aspects of
       transition systems and the merge-and-shrink representation (checking
@@ -90,29 +117,22 @@ void MergeAndShrinkHeuristic::extract_factors(FactoredTransitionSystem &fts) {
       factored_transition_system.h on improving the interface of that class
       (and also related classes like TransitionSystem etc).
     */
-    assert(mas_representations.empty());
-
     int num_active_factors = fts.get_num_active_entries();
     if (log.is_at_least_normal()) {
         log << "Number of remaining factors: " << num_active_factors << endl;
     }
 
-    bool unsolvalbe = extract_unsolvable_factor(fts);
+    bool unsolvalbe = extract_unsolvable_factor(fts, builder);
     if (!unsolvalbe) {
-        extract_nontrivial_factors(fts);
-    }
-
-    int num_factors_kept = mas_representations.size();
-    if (log.is_at_least_normal()) {
-        log << "Number of factors kept: " << num_factors_kept << endl;
+        extract_nontrivial_factors(fts, builder);
     }
 }
 
 int MergeAndShrinkHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int heuristic = 0;
-    for (const unique_ptr<MergeAndShrinkRepresentation> &mas_representation : mas_representations) {
-        int cost = mas_representation->get_value(state);
+    for (int factor = 0; factor < representation->get_num_factors(); ++factor) {
+        int cost = representation->get_value(factor, state);
         if (cost == PRUNED_STATE || cost == INF) {
             // If state is unreachable or irrelevant, we encountered a dead end.
             return DEAD_END;
@@ -173,6 +193,12 @@ public:
 
         Heuristic::add_options_to_feature(*this);
         add_merge_and_shrink_algorithm_options_to_feature(*this);
+        add_option<string>(
+            "save_to_file",
+            "If given, save the final merge-and-shrink representations to "
+            "this file, so that they can be loaded with "
+            "merge_and_shrink_from_file.",
+            plugins::ArgumentInfo::NO_DEFAULT);
 
         document_note(
             "Note",
@@ -232,4 +258,39 @@ public:
 };
 
 static plugins::FeaturePlugin<MergeAndShrinkHeuristicFeature> _plugin;
+
+class MergeAndShrinkHeuristicFromFileFeature : public plugins::TypedFeature<Evaluator, MergeAndShrinkHeuristic> {
+public:
+    MergeAndShrinkHeuristicFromFileFeature() : TypedFeature("merge_and_shrink_from_file") {
+        document_title("Merge-and-shrink heuristic from file");
+        document_synopsis(
+            "Load the merge-and-shrink representations saved with the "
+            "{{{save_to_file}}} option of the merge-and-shrink heuristic. "
+            "The file is mapped into memory, so concurrent planner processes "
+            "using the same file share the memory for the representations.");
+
+        Heuristic::add_options_to_feature(*this);
+        add_option<string>(
+            "file",
+            "File written by merge_and_shrink(save_to_file=...).");
+
+        document_note(
+            "Note",
+            "The file must have been computed for the same task. We only "
+            "check that the variables and their domain sizes match, so it is "
+            "up to the user to use the same operator costs and task "
+            "transformation.");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "not supported");
+
+        document_property("admissible", "yes (if computed for the same task)");
+        document_property("consistent", "yes (if computed for the same task)");
+        document_property("safe", "yes");
+        document_property("preferred operators", "no");
+    }
+};
+
+static plugins::FeaturePlugin<MergeAndShrinkHeuristicFromFileFeature> _plugin_from_file;
 }
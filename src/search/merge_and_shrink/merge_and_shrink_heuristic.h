@@ -6,17 +6,26 @@
 #include <memory>
 
 namespace merge_and_shrink {
+class CompactRepresentation;
+class CompactRepresentationBuilder;
 class FactoredTransitionSystem;
-class MergeAndShrinkRepresentation;
 
 class MergeAndShrinkHeuristic : public Heuristic {
-    // The final merge-and-shrink representations, storing goal distances.
-    std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
+    /*
+      The final merge-and-shrink representations, storing goal distances,
+      either computed by the merge-and-shrink algorithm or loaded from a file.
+    */
+    std::unique_ptr<CompactRepresentation> representation;
 
-    void extract_factor(FactoredTransitionSystem &fts, int index);
-    bool extract_unsolvable_factor(FactoredTransitionSystem &fts);
-    void extract_nontrivial_factors(FactoredTransitionSystem &fts);
-    void extract_factors(FactoredTransitionSystem &fts);
+    void extract_factor(
+        FactoredTransitionSystem &fts, int index,
+        CompactRepresentationBuilder &builder);
+    bool extract_unsolvable_factor(
+        FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder);
+    void extract_nontrivial_factors(
+        FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder);
+    void extract_factors(
+        FactoredTransitionSystem &fts, CompactRepresentationBuilder &builder);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
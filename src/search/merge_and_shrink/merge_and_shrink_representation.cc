@@ -1,5 +1,6 @@
 #include "merge_and_shrink_representation.h"
 
+#include "compact_representation.h"
 #include "distances.h"
 #include "types.h"
 
@@ -81,6 +82,11 @@ void MergeAndShrinkRepresentationLeaf::dump(utils::LogProxy &log) const {
     }
 }
 
+int MergeAndShrinkRepresentationLeaf::add_to(
+    CompactRepresentationBuilder &builder) const {
+    return builder.add_leaf(var_id, lookup_table);
+}
+
 
 MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
     unique_ptr<MergeAndShrinkRepresentation> left_child_,
@@ -161,4 +167,11 @@ void MergeAndShrinkRepresentationMerge::dump(utils::LogProxy &log) const {
         right_child->dump(log);
     }
 }
+
+int MergeAndShrinkRepresentationMerge::add_to(
+    CompactRepresentationBuilder &builder) const {
+    int left_node = left_child->add_to(builder);
+    int right_node = right_child->add_to(builder);
+    return builder.add_merge(left_node, right_node, lookup_table);
+}
 }
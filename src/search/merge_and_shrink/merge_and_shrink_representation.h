@@ -11,6 +11,7 @@ class LogProxy;
 }
 
 namespace merge_and_shrink {
+class CompactRepresentationBuilder;
 class Distances;
 class MergeAndShrinkRepresentation {
 protected:
@@ -37,6 +38,8 @@ public:
        to PRUNED_STATE. */
     virtual bool is_total() const = 0;
     virtual void dump(utils::LogProxy &log) const = 0;
+    // Add the nodes of this representation and return the ID of the root.
+    virtual int add_to(CompactRepresentationBuilder &builder) const = 0;
 };
 
 
@@ -54,6 +57,7 @@ public:
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
     virtual void dump(utils::LogProxy &log) const override;
+    virtual int add_to(CompactRepresentationBuilder &builder) const override;
 };
 
 
@@ -73,6 +77,7 @@ public:
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
     virtual void dump(utils::LogProxy &log) const override;
+    virtual int add_to(CompactRepresentationBuilder &builder) const override;
 };
 }
 
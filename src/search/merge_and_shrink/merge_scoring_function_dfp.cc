@@ -24,7 +24,7 @@ static vector<int> compute_label_ranks(
 
     for (const LocalLabelInfo &local_label_info : ts) {
         const LabelGroup &label_group = local_label_info.get_label_group();
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        span<const Transition> transitions = ts.get_transitions(local_label_info);
         // Relevant labels with no transitions have a rank of infinity.
         int label_rank = INF;
         bool group_relevant = false;
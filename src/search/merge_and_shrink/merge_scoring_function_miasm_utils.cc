@@ -32,7 +32,8 @@ unique_ptr<TransitionSystem> copy_and_shrink_ts(
       function shrink_factor in utils.cc
     */
     StateEquivalenceRelation equivalence_relation =
-        shrink_strategy.compute_equivalence_relation(ts, distances, new_size, log);
+        shrink_strategy.compute_equivalence_relation(
+            ts, distances, new_size, 1, log);
     // TODO: We currently violate this; see issue250
     //assert(equivalence_relation.size() <= target_size);
     int new_num_states = equivalence_relation.size();
@@ -111,6 +112,7 @@ unique_ptr<TransitionSystem> shrink_before_merge_externally(
         fts.get_labels(),
         (ts1 ? *ts1 : original_ts1),
         (ts2 ? *ts2 : original_ts2),
+        1,
         log);
 }
 }
@@ -8,6 +8,7 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <algorithm>
@@ -140,7 +141,8 @@ void ShrinkBisimulation::compute_signatures(
     const TransitionSystem &ts,
     const Distances &distances,
     vector<Signature> &signatures,
-    const vector<int> &state_to_group) const {
+    const vector<int> &state_to_group,
+    int num_threads) const {
     assert(signatures.empty());
 
     // Step 1: Compute bare state signatures (without transition information).
@@ -158,7 +160,6 @@ void ShrinkBisimulation::compute_signatures(
     signatures.push_back(Signature(SENTINEL, false, -1, SuccessorSignature(), -1));
 
     // Step 2: Add transition information.
-    int label_group_counter = 0;
     /*
       Note that the final result of the bisimulation may depend on the
       order in which transitions are considered below.
@@ -183,32 +184,58 @@ void ShrinkBisimulation::compute_signatures(
                                                 threshold=1),
             label_reduction=exact(before_shrinking=true,before_merging=false)))
     */
+    vector<const LocalLabelInfo *> local_label_infos;
     for (const LocalLabelInfo &local_label_info : ts) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        for (const Transition &transition : transitions) {
-            assert(signatures[transition.src + 1].state == transition.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = distances.get_goal_distance(transition.src);
-                int target_h = distances.get_goal_distance(transition.target);
-                if (src_h == INF || target_h == INF) {
-                    // We skip transitions connected to an irrelevant state.
-                    skip_transition = true;
-                } else {
-                    int cost = local_label_info.get_cost();
-                    assert(target_h + cost >= src_h);
-                    skip_transition = (target_h + cost != src_h);
+        local_label_infos.push_back(&local_label_info);
+    }
+
+    /*
+      Transitions are sorted by source state, so we split the states into
+      ranges and let each thread add the transitions of one range. The order
+      in which successor pairs are added does not matter, since we sort them
+      in step 3.
+    */
+    int num_states = ts.get_size();
+    auto get_range_start = [num_states, num_threads](int range) {
+            return static_cast<int>(
+                static_cast<long long>(num_states) * range / num_threads);
+        };
+    utils::parallel_for(num_threads, num_threads, [&](int range) {
+            int range_start = get_range_start(range);
+            int range_end = get_range_start(range + 1);
+            int num_label_groups = local_label_infos.size();
+            for (int label_group = 0; label_group < num_label_groups; ++label_group) {
+                const LocalLabelInfo &local_label_info = *local_label_infos[label_group];
+                span<const Transition> transitions =
+                    ts.get_transitions(local_label_info);
+                auto it = lower_bound(
+                    transitions.begin(), transitions.end(),
+                    Transition(range_start, 0));
+                for (; it != transitions.end() && it->src < range_end; ++it) {
+                    const Transition &transition = *it;
+                    assert(signatures[transition.src + 1].state == transition.src);
+                    bool skip_transition = false;
+                    if (greedy) {
+                        int src_h = distances.get_goal_distance(transition.src);
+                        int target_h = distances.get_goal_distance(transition.target);
+                        if (src_h == INF || target_h == INF) {
+                            // We skip transitions connected to an irrelevant state.
+                            skip_transition = true;
+                        } else {
+                            int cost = local_label_info.get_cost();
+                            assert(target_h + cost >= src_h);
+                            skip_transition = (target_h + cost != src_h);
+                        }
+                    }
+                    if (!skip_transition) {
+                        int target_group = state_to_group[transition.target];
+                        assert(target_group != -1 && target_group != SENTINEL);
+                        signatures[transition.src + 1].succ_signature.push_back(
+                            make_pair(label_group, target_group));
+                    }
                 }
             }
-            if (!skip_transition) {
-                int target_group = state_to_group[transition.target];
-                assert(target_group != -1 && target_group != SENTINEL);
-                signatures[transition.src + 1].succ_signature.push_back(
-                    make_pair(label_group_counter, target_group));
-            }
-        }
-        ++label_group_counter;
-    }
+        });
 
     /* Step 3: Canonicalize the representation. The resulting
        signatures must satisfy the following properties:
@@ -225,20 +252,25 @@ void ShrinkBisimulation::compute_signatures(
           bisimulation round.
      */
 
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
-    }
+    utils::parallel_for(num_threads, num_threads, [&](int range) {
+            // Skip the sentinels, which have empty successor signatures.
+            for (int i = get_range_start(range) + 1;
+                 i < get_range_start(range + 1) + 1; ++i) {
+                SuccessorSignature &succ_sig = signatures[i].succ_signature;
+                ::sort(succ_sig.begin(), succ_sig.end());
+                succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
+                               succ_sig.end());
+            }
+        });
 
-    ::sort(signatures.begin(), signatures.end());
+    utils::parallel_sort(num_threads, signatures);
 }
 
 StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
     const TransitionSystem &ts,
     const Distances &distances,
     int target_size,
+    int num_threads,
     utils::LogProxy &) const {
     assert(distances.are_goal_distances_computed());
     int num_states = ts.get_size();
@@ -259,7 +291,8 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
         stable = true;
 
         signatures.clear();
-        compute_signatures(ts, distances, signatures, state_to_group);
+        compute_signatures(
+            ts, distances, signatures, state_to_group, num_threads);
 
         // Verify size of signatures and presence of sentinels.
         assert(static_cast<int>(signatures.size()) == num_states + 2);
@@ -34,7 +34,8 @@ class ShrinkBisimulation : public ShrinkStrategy {
         const TransitionSystem &ts,
         const Distances &distances,
         std::vector<Signature> &signatures,
-        const std::vector<int> &state_to_group) const;
+        const std::vector<int> &state_to_group,
+        int num_threads) const;
 protected:
     virtual void dump_strategy_specific_options(utils::LogProxy &log) const override;
     virtual std::string name() const override;
@@ -45,6 +46,7 @@ public:
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size,
+        int num_threads,
         utils::LogProxy &log) const override;
 
     virtual bool requires_init_distances() const override {
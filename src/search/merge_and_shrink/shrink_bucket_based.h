@@ -57,6 +57,7 @@ public:
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size,
+        int num_threads,
         utils::LogProxy &log) const override;
     static void add_options_to_feature(plugins::Feature &feature);
 };
@@ -35,11 +35,14 @@ public:
       However, it may attempt to e.g. compute an equivalence relation that
       results in shrinking the transition system in an information-preserving
       way.
+
+      Strategies may use up to num_threads threads for the computation.
     */
     virtual StateEquivalenceRelation compute_equivalence_relation(
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size,
+        int num_threads,
         utils::LogProxy &log) const = 0;
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
@@ -5,13 +5,18 @@
 
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -59,15 +64,15 @@ void LocalLabelInfo::recompute_cost(const Labels &labels) {
     }
 }
 
-void LocalLabelInfo::replace_transitions(vector<Transition> &&new_transitions) {
-    transitions = move(new_transitions);
-    assert(is_consistent());
+void LocalLabelInfo::set_transitions(size_t begin, size_t size) {
+    transitions_begin = begin;
+    num_transitions = size;
 }
 
 void LocalLabelInfo::merge_local_label_info(LocalLabelInfo &local_label_info) {
     assert(is_consistent());
     assert(local_label_info.is_consistent());
-    assert(transitions == local_label_info.transitions);
+    assert(num_transitions == local_label_info.num_transitions);
     label_group.insert(
         label_group.end(),
         make_move_iterator(local_label_info.label_group.begin()),
@@ -79,14 +84,13 @@ void LocalLabelInfo::merge_local_label_info(LocalLabelInfo &local_label_info) {
 }
 
 void LocalLabelInfo::deactivate() {
-    utils::release_vector_memory(transitions);
+    num_transitions = 0;
     utils::release_vector_memory(label_group);
     cost = -1;
 }
 
 bool LocalLabelInfo::is_consistent() const {
-    return utils::is_sorted_unique(label_group) &&
-           utils::is_sorted_unique(transitions);
+    return utils::is_sorted_unique(label_group);
 }
 
 
@@ -109,6 +113,95 @@ TransitionSystemConstIterator &TransitionSystemConstIterator::operator++() {
     return *this;
 }
 
+static uint64_t load_key(const Transition &transition) {
+    uint64_t key;
+    memcpy(&key, &transition, sizeof(key));
+    return key;
+}
+
+static void store_key(Transition &transition, uint64_t key) {
+    static_assert(is_trivially_copyable_v<Transition>);
+    memcpy(static_cast<void *>(&transition), &key, sizeof(key));
+}
+
+/*
+  Sort the transitions in [begin, end) and remove duplicates. Return the
+  end of the sorted range. All states must be smaller than num_states.
+
+  Large ranges are sorted with an LSD radix sort on 64-bit keys that pack
+  the source and target state, only sorting by the bits needed for the
+  given number of states. To keep the memory overhead at one key per
+  transition, the passes alternate between the scratch space keys and the
+  memory of the range itself, which holds packed keys during the sort.
+*/
+static vector<Transition>::iterator sort_unique_transitions(
+    vector<Transition>::iterator begin, vector<Transition>::iterator end,
+    int num_states, vector<uint64_t> &keys) {
+    static_assert(sizeof(Transition) == sizeof(uint64_t));
+    const size_t RADIX_SORT_MIN_SIZE = 256;
+    const int DIGIT_BITS = 11;
+    const uint64_t DIGIT_MASK = (uint64_t(1) << DIGIT_BITS) - 1;
+
+    if (is_sorted(begin, end)) {
+        return unique(begin, end);
+    }
+    size_t size = end - begin;
+    if (size < RADIX_SORT_MIN_SIZE) {
+        sort(begin, end);
+        return unique(begin, end);
+    }
+
+    int state_bits = max(1, static_cast<int>(
+                             bit_width(static_cast<unsigned>(num_states - 1))));
+    for (auto it = begin; it != end; ++it) {
+        assert(it->src < num_states && it->target < num_states);
+        store_key(*it, (static_cast<uint64_t>(it->src) << state_bits) |
+                  static_cast<uint64_t>(it->target));
+    }
+    keys.resize(size);
+    bool keys_in_range = true;
+    vector<size_t> counts(DIGIT_MASK + 1);
+    for (int shift = 0; shift < 2 * state_bits; shift += DIGIT_BITS) {
+        auto get_digit = [shift](uint64_t key) {
+                return (key >> shift) & DIGIT_MASK;
+            };
+        fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < size; ++i) {
+            ++counts[get_digit(keys_in_range ? load_key(begin[i]) : keys[i])];
+        }
+        size_t offset = 0;
+        for (size_t &count : counts) {
+            size_t digit_count = count;
+            count = offset;
+            offset += digit_count;
+        }
+        if (keys_in_range) {
+            for (size_t i = 0; i < size; ++i) {
+                uint64_t key = load_key(begin[i]);
+                keys[counts[get_digit(key)]++] = key;
+            }
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                store_key(begin[counts[get_digit(keys[i])]++], keys[i]);
+            }
+        }
+        keys_in_range = !keys_in_range;
+    }
+
+    uint64_t target_mask = (uint64_t(1) << state_bits) - 1;
+    auto pos = begin;
+    uint64_t previous_key = 0;
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t key = keys_in_range ? load_key(begin[i]) : keys[i];
+        if (i == 0 || key != previous_key) {
+            *pos++ = Transition(static_cast<int>(key >> state_bits),
+                                static_cast<int>(key & target_mask));
+        }
+        previous_key = key;
+    }
+    return pos;
+}
+
 /*
   Implementation note: Transitions are grouped by their local labels,
   not by source state or any such thing. Such a grouping is beneficial
@@ -130,6 +223,7 @@ TransitionSystem::TransitionSystem(
     const Labels &labels,
     vector<int> &&label_to_local_label,
     vector<LocalLabelInfo> &&local_label_infos,
+    vector<Transition> &&transitions,
     int num_states,
     vector<bool> &&goal_states,
     int init_state)
@@ -138,6 +232,7 @@ TransitionSystem::TransitionSystem(
       labels(move(labels)),
       label_to_local_label(move(label_to_local_label)),
       local_label_infos(move(local_label_infos)),
+      transitions(move(transitions)),
       num_states(num_states),
       goal_states(move(goal_states)),
       init_state(init_state) {
@@ -150,6 +245,7 @@ TransitionSystem::TransitionSystem(const TransitionSystem &other)
       labels(other.labels),
       label_to_local_label(other.label_to_local_label),
       local_label_infos(other.local_label_infos),
+      transitions(other.transitions),
       num_states(other.num_states),
       goal_states(other.goal_states),
       init_state(other.init_state) {
@@ -162,6 +258,7 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     const Labels &labels,
     const TransitionSystem &ts1,
     const TransitionSystem &ts2,
+    int num_threads,
     utils::LogProxy &log) {
     if (log.is_at_least_verbose()) {
         log << "Merging " << ts1.get_description() << " and "
@@ -205,12 +302,22 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
       (B) they are both dead in T (e.g., this includes the case where
           l is dead in T1 only and l' is dead in T2 only, so they are not
           locally equivalent in either of the components).
+
+      We first collect all refinements of label groups of T1 by the label
+      groups of T2 and then compute their transitions independently of each
+      other.
     */
-    int multiplier = ts2_size;
-    LabelGroup dead_labels;
+    struct ProductGroup {
+        span<const Transition> transitions1;
+        span<const Transition> transitions2;
+        LabelGroup labels;
+        size_t transitions_begin;
+    };
+    vector<ProductGroup> product_groups;
+    size_t num_transitions = 0;
     for (const LocalLabelInfo &local_label_info : ts1) {
         const LabelGroup &group1 = local_label_info.get_label_group();
-        const vector<Transition> &transitions1 = local_label_info.get_transitions();
+        span<const Transition> transitions1 = ts1.get_transitions(local_label_info);
 
         // Distribute the labels of this group among the "buckets"
         // corresponding to the groups of ts2.
@@ -221,45 +328,65 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         }
         // Now buckets contains all equivalence classes that are
         // refinements of group1.
-
-        // Now create the new groups together with their transitions.
         for (auto &bucket : buckets) {
-            const vector<Transition> &transitions2 =
-                ts2.local_label_infos[bucket.first].get_transitions();
-
-            // Create the new transitions for this bucket
-            vector<Transition> new_transitions;
+            span<const Transition> transitions2 =
+                ts2.get_transitions(ts2.local_label_infos[bucket.first]);
+            size_t max_size = vector<Transition>().max_size();
             if (!transitions1.empty() && !transitions2.empty()
-                && transitions1.size() > new_transitions.max_size() / transitions2.size())
+                && transitions1.size() > max_size / transitions2.size())
                 utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
-            new_transitions.reserve(transitions1.size() * transitions2.size());
-            for (const Transition &transition1 : transitions1) {
+            size_t group_size = transitions1.size() * transitions2.size();
+            if (group_size > max_size - num_transitions)
+                utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+            product_groups.push_back(
+                {transitions1, transitions2, move(bucket.second), num_transitions});
+            num_transitions += group_size;
+        }
+    }
+
+    /*
+      The products of the sorted and unique transitions of two local labels
+      are unique, so we know the size of each segment in advance and can
+      create the transitions of all groups directly in the final buffer.
+    */
+    vector<Transition> transitions(num_transitions, Transition(0, 0));
+    int multiplier = ts2_size;
+    utils::parallel_for(
+        num_threads, product_groups.size(), [&](int group_id) {
+            ProductGroup &group = product_groups[group_id];
+            auto new_transitions = transitions.begin() + group.transitions_begin;
+            auto pos = new_transitions;
+            for (const Transition &transition1 : group.transitions1) {
                 int src1 = transition1.src;
                 int target1 = transition1.target;
-                for (const Transition &transition2 : transitions2) {
+                for (const Transition &transition2 : group.transitions2) {
                     int src2 = transition2.src;
                     int target2 = transition2.target;
                     int src = src1 * multiplier + src2;
                     int target = target1 * multiplier + target2;
-                    new_transitions.emplace_back(src, target);
+                    *pos++ = Transition(src, target);
                 }
             }
+            sort(new_transitions, pos);
+            sort(group.labels.begin(), group.labels.end());
+        });
 
-            // Create a new group if the transitions are not empty
-            LabelGroup &new_labels = bucket.second;
-            if (new_transitions.empty()) {
-                dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
-            } else {
-                sort(new_transitions.begin(), new_transitions.end());
-                sort(new_labels.begin(), new_labels.end());
-                int new_local_label = local_label_infos.size();
-                int cost = INF;
-                for (int label : new_labels) {
-                    cost = min(ts1.labels.get_label_cost(label), cost);
-                    label_to_local_label[label] = new_local_label;
-                }
-                local_label_infos.emplace_back(move(new_labels), move(new_transitions), cost);
+    // Create a new local label for each group with non-empty transitions.
+    LabelGroup dead_labels;
+    for (ProductGroup &group : product_groups) {
+        LabelGroup &new_labels = group.labels;
+        size_t group_size = group.transitions1.size() * group.transitions2.size();
+        if (group_size == 0) {
+            dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
+        } else {
+            int new_local_label = local_label_infos.size();
+            int cost = INF;
+            for (int label : new_labels) {
+                cost = min(ts1.labels.get_label_cost(label), cost);
+                label_to_local_label[label] = new_local_label;
             }
+            local_label_infos.emplace_back(
+                move(new_labels), group.transitions_begin, group_size, cost);
         }
     }
 
@@ -279,7 +406,8 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
             label_to_local_label[label] = new_local_label;
         }
         // Dead labels have empty transitions
-        local_label_infos.emplace_back(move(dead_labels), vector<Transition>(), cost);
+        local_label_infos.emplace_back(
+            move(dead_labels), num_transitions, 0, cost);
     }
 
     return utils::make_unique_ptr<TransitionSystem>(
@@ -288,6 +416,7 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         ts1.labels,
         move(label_to_local_label),
         move(local_label_infos),
+        move(transitions),
         num_states,
         move(goal_states),
         init_state
@@ -307,13 +436,14 @@ void TransitionSystem::compute_equivalent_local_labels() {
     for (int local_label1 = 0; local_label1 < num_local_labels;
          ++local_label1) {
         if (local_label_infos[local_label1].is_active()) {
-            const vector<Transition> &transitions1 = local_label_infos[local_label1].get_transitions();
+            span<const Transition> transitions1 = get_transitions(local_label_infos[local_label1]);
             for (int local_label2 = local_label1 + 1;
                  local_label2 < num_local_labels; ++local_label2) {
                 if (local_label_infos[local_label2].is_active()) {
-                    const vector<Transition> &transitions2 = local_label_infos[local_label2].get_transitions();
+                    span<const Transition> transitions2 = get_transitions(local_label_infos[local_label2]);
                     // Comparing transitions directly works because they are sorted and unique.
-                    if (transitions1 == transitions2) {
+                    if (equal(transitions1.begin(), transitions1.end(),
+                              transitions2.begin(), transitions2.end())) {
                         for (int label : local_label_infos[local_label2].get_label_group()) {
                             label_to_local_label[label] = local_label1;
                         }
@@ -324,10 +454,37 @@ void TransitionSystem::compute_equivalent_local_labels() {
             }
         }
     }
+    compact_transitions();
+    // Release the memory if many transitions have been removed.
+    if (transitions.capacity() > 2 * transitions.size()) {
+        transitions.shrink_to_fit();
+    }
 
     assert(is_valid());
 }
 
+void TransitionSystem::compact_transitions() {
+    /*
+      Move the segments to the front one after the other. This is safe
+      because the segments are ordered like the local labels.
+    */
+    size_t new_end = 0;
+    for (LocalLabelInfo &local_label_info : local_label_infos) {
+        size_t begin = local_label_info.get_transitions_begin();
+        size_t size = local_label_info.is_active() ?
+            local_label_info.get_num_transitions() : 0;
+        assert(begin >= new_end);
+        if (begin != new_end) {
+            move(transitions.begin() + begin,
+                 transitions.begin() + begin + size,
+                 transitions.begin() + new_end);
+        }
+        local_label_info.set_transitions(new_end, size);
+        new_end += size;
+    }
+    transitions.erase(transitions.begin() + new_end, transitions.end());
+}
+
 void TransitionSystem::apply_abstraction(
     const StateEquivalenceRelation &state_equivalence_relation,
     const vector<int> &abstraction_mapping,
@@ -356,31 +513,33 @@ void TransitionSystem::apply_abstraction(
     }
     goal_states = move(new_goal_states);
 
-    // Update all transitions.
+    /*
+      Update all transitions in place. The new segment of a local label
+      starts at or before its old segment and is at most as long, so we
+      can write the mapped transitions of each segment directly behind the
+      new segment of the previous local label.
+    */
+    vector<uint64_t> keys;
+    size_t new_end = 0;
     for (LocalLabelInfo &local_label_info : local_label_infos) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        if (!transitions.empty()) {
-            vector<Transition> new_transitions;
-            /*
-            We reserve more memory than necessary here, but this is better
-            than potentially resizing the vector several times when inserting
-            transitions one after the other. See issue604-v6.
-
-            An alternative could be to not use a new vector, but to modify
-            the existing transitions inplace, and to remove all empty
-            positions in the end. This would be more ugly, though.
-            */
-            new_transitions.reserve(transitions.size());
-            for (const Transition &transition : transitions) {
-                int src = abstraction_mapping[transition.src];
-                int target = abstraction_mapping[transition.target];
-                if (src != PRUNED_STATE && target != PRUNED_STATE)
-                    new_transitions.emplace_back(src, target);
-            }
-            utils::sort_unique(new_transitions);
-            local_label_info.replace_transitions(move(new_transitions));
+        size_t begin = local_label_info.get_transitions_begin();
+        size_t size = local_label_info.is_active() ?
+            local_label_info.get_num_transitions() : 0;
+        assert(begin >= new_end);
+        auto new_begin = transitions.begin() + new_end;
+        auto pos = new_begin;
+        for (size_t i = begin; i < begin + size; ++i) {
+            int src = abstraction_mapping[transitions[i].src];
+            int target = abstraction_mapping[transitions[i].target];
+            if (src != PRUNED_STATE && target != PRUNED_STATE)
+                *pos++ = Transition(src, target);
         }
+        pos = sort_unique_transitions(
+            new_begin, pos, new_num_states, keys);
+        local_label_info.set_transitions(new_end, pos - new_begin);
+        new_end = pos - transitions.begin();
     }
+    transitions.erase(transitions.begin() + new_end, transitions.end());
 
     compute_equivalent_local_labels();
 
@@ -439,10 +598,15 @@ void TransitionSystem::apply_label_reduction(
           Iterate over the label mapping. For each new label, go over the
           reduced labels to combine their transitions into the transitions
           of the new label. Also store, for each local label, the labels
-          removed from them. Add the new label together with its transitions
-          as a new local label and update the label_to_local_label mapping.
+          removed from them. Add the new label as a new local label and
+          update the label_to_local_label mapping. We add the transitions
+          of the new local labels to the buffer below.
         */
         unordered_map<int, vector<int>> local_label_to_old_labels;
+        vector<vector<Transition>> new_transitions_by_mapping;
+        new_transitions_by_mapping.reserve(label_mapping.size());
+        size_t num_new_transitions = 0;
+        vector<uint64_t> keys;
         for (const pair<int, vector<int>> &mapping: label_mapping) {
             const vector<int> &old_labels = mapping.second;
             assert(old_labels.size() >= 2);
@@ -451,14 +615,23 @@ void TransitionSystem::apply_label_reduction(
             for (int old_label : old_labels) {
                 int old_local_label = label_to_local_label[old_label];
                 if (seen_local_labels.insert(old_local_label).second) {
-                    const vector<Transition> &transitions = local_label_infos[old_local_label].get_transitions();
-                    new_label_transitions.insert(new_label_transitions.end(), transitions.begin(), transitions.end());
+                    span<const Transition> old_transitions =
+                        get_transitions(local_label_infos[old_local_label]);
+                    new_label_transitions.insert(
+                        new_label_transitions.end(),
+                        old_transitions.begin(), old_transitions.end());
                 }
                 local_label_to_old_labels[old_local_label].push_back(old_label);
                 // Reset (for consistency only, old labels are never accessed).
                 label_to_local_label[old_label] = -1;
             }
-            utils::sort_unique(new_label_transitions);
+            new_label_transitions.erase(
+                sort_unique_transitions(
+                    new_label_transitions.begin(), new_label_transitions.end(),
+                    num_states, keys),
+                new_label_transitions.end());
+            num_new_transitions += new_label_transitions.size();
+            new_transitions_by_mapping.push_back(move(new_label_transitions));
 
             int new_label = mapping.first;
             int new_local_label = local_label_infos.size();
@@ -466,8 +639,10 @@ void TransitionSystem::apply_label_reduction(
             int new_cost = labels.get_label_cost(new_label);
 
             LabelGroup new_label_group = {new_label};
-            local_label_infos.emplace_back(move(new_label_group), move(new_label_transitions), new_cost);
+            local_label_infos.emplace_back(
+                move(new_label_group), transitions.size(), 0, new_cost);
         }
+        utils::release_vector_memory(keys);
 
         /*
           Remove all labels of all affected local labels and recompute the
@@ -479,6 +654,24 @@ void TransitionSystem::apply_label_reduction(
             local_label_infos[entry.first].recompute_cost(labels);
         }
 
+        /*
+          Drop the transitions of local labels that became inactive before
+          adding the transitions of the new local labels at the end.
+        */
+        compact_transitions();
+        transitions.reserve(transitions.size() + num_new_transitions);
+        int first_new_local_label = local_label_infos.size() - label_mapping.size();
+        for (size_t i = 0; i < new_transitions_by_mapping.size(); ++i) {
+            vector<Transition> &new_label_transitions = new_transitions_by_mapping[i];
+            size_t transitions_begin = transitions.size();
+            transitions.insert(
+                transitions.end(),
+                new_label_transitions.begin(), new_label_transitions.end());
+            local_label_infos[first_new_local_label + i].set_transitions(
+                transitions_begin, new_label_transitions.size());
+            utils::release_vector_memory(new_label_transitions);
+        }
+
         compute_equivalent_local_labels();
     }
 
@@ -492,8 +685,21 @@ string TransitionSystem::tag() const {
 }
 
 bool TransitionSystem::are_local_labels_consistent() const {
+    size_t previous_end = 0;
+    for (const LocalLabelInfo &local_label_info : local_label_infos) {
+        size_t begin = local_label_info.get_transitions_begin();
+        size_t end = begin + local_label_info.get_num_transitions();
+        if (begin < previous_end || end > transitions.size())
+            return false;
+        previous_end = end;
+    }
     for (const LocalLabelInfo &local_label_info : *this) {
-        if (!local_label_info.is_consistent())
+        span<const Transition> local_transitions = get_transitions(local_label_info);
+        if (!local_label_info.is_consistent() ||
+            adjacent_find(local_transitions.begin(), local_transitions.end(),
+                          [](const Transition &t1, const Transition &t2) {
+                              return t1 >= t2;
+                          }) != local_transitions.end())
             return false;
     }
     return true;
@@ -564,7 +770,7 @@ bool TransitionSystem::is_solvable(const Distances &distances) const {
 int TransitionSystem::compute_total_transitions() const {
     int total = 0;
     for (const LocalLabelInfo &local_label_info : *this) {
-        total += local_label_info.get_transitions().size();
+        total += local_label_info.get_num_transitions();
     }
     return total;
 }
@@ -598,8 +804,7 @@ void TransitionSystem::dump_dot_graph(utils::LogProxy &log) const {
         }
         for (const LocalLabelInfo &local_label_info : *this) {
             const LabelGroup &label_group = local_label_info.get_label_group();
-            const vector<Transition> &transitions = local_label_info.get_transitions();
-            for (const Transition &transition : transitions) {
+            for (const Transition &transition : get_transitions(local_label_info)) {
                 int src = transition.src;
                 int target = transition.target;
                 log << "    node" << src << " -> node" << target << " [label = ";
@@ -622,7 +827,7 @@ void TransitionSystem::dump_labels_and_transitions(utils::LogProxy &log) const {
             const LabelGroup &label_group = local_label_info.get_label_group();
             log << "labels: " << label_group << endl;
             log << "transitions: ";
-            const vector<Transition> &transitions = local_label_info.get_transitions();
+            span<const Transition> transitions = get_transitions(local_label_info);
             for (size_t i = 0; i < transitions.size(); ++i) {
                 int src = transitions[i].src;
                 int target = transitions[i].target;
@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -47,22 +48,29 @@ using LabelGroup = std::vector<int>;
   Class for representing groups of labels with equivalent transitions in a
   transition system. See also documentation for TransitionSystem.
 
-  The local label is in a consistent state if label_group and transitions
-  are sorted and unique.
+  The transitions themselves are stored by the transition system. A local
+  label only stores the position of its transitions in the transition
+  system's buffer of transitions.
+
+  The local label is in a consistent state if label_group is sorted and
+  unique.
 */
 class LocalLabelInfo {
     // The sorted set of labels with identical transitions in a transition system.
     LabelGroup label_group;
-    std::vector<Transition> transitions;
+    std::size_t transitions_begin;
+    std::size_t num_transitions;
     // The cost is the minimum cost over all labels in label_group.
     int cost;
 public:
     LocalLabelInfo(
         LabelGroup &&label_group,
-        std::vector<Transition> &&transitions,
+        std::size_t transitions_begin,
+        std::size_t num_transitions,
         int cost)
         : label_group(move(label_group)),
-          transitions(move(transitions)),
+          transitions_begin(transitions_begin),
+          num_transitions(num_transitions),
           cost(cost) {
         assert(is_consistent());
     }
@@ -80,7 +88,7 @@ public:
     void remove_labels(const std::vector<int> &old_labels);
 
     void recompute_cost(const Labels &labels);
-    void replace_transitions(std::vector<Transition> &&new_transitions);
+    void set_transitions(std::size_t begin, std::size_t size);
 
     /*
       The given local label must have identical transitions. Its labels are
@@ -101,8 +109,12 @@ public:
         return label_group;
     }
 
-    const std::vector<Transition> &get_transitions() const {
-        return transitions;
+    std::size_t get_transitions_begin() const {
+        return transitions_begin;
+    }
+
+    std::size_t get_num_transitions() const {
+        return num_transitions;
     }
 
     int get_cost() const {
@@ -166,6 +178,19 @@ private:
     */
     std::vector<int> label_to_local_label;
     std::vector<LocalLabelInfo> local_label_infos;
+    /*
+      The transitions of all local labels in a single buffer. The
+      transitions of each local label form a contiguous segment that is
+      sorted (by source, by target) and has no duplicates. The segments
+      are ordered like the local labels, i.e., local labels that are added
+      later store their transitions further back in the buffer. Inactive
+      local labels have no transitions.
+
+      Between two transformations, the segments may be separated by unused
+      transitions (e.g., of deactivated local labels), which are removed by
+      compact_transitions().
+    */
+    std::vector<Transition> transitions;
 
     int num_states;
     std::vector<bool> goal_states;
@@ -177,13 +202,17 @@ private:
     */
     void compute_equivalent_local_labels();
 
+    // Remove the unused transitions between the segments of local labels.
+    void compact_transitions();
+
     // Statistics and output
     int compute_total_transitions() const;
     std::string get_description() const;
 
     /*
       The transitions for every group of locally equivalent labels are
-      sorted (by source, by target) and there are no duplicates.
+      sorted (by source, by target) and there are no duplicates, and the
+      segments of the local labels are ordered and do not overlap.
     */
     bool are_local_labels_consistent() const;
 
@@ -199,6 +228,7 @@ public:
         const Labels &labels,
         std::vector<int> &&label_to_local_label,
         std::vector<LocalLabelInfo> &&local_label_infos,
+        std::vector<Transition> &&transitions,
         int num_states,
         std::vector<bool> &&goal_states,
         int init_state);
@@ -209,11 +239,15 @@ public:
 
       Invariant: the children ts1 and ts2 must be solvable.
       (It is a bug to merge an unsolvable transition system.)
+
+      The transitions of the new label groups are independent of each other
+      and are computed with up to num_threads threads.
     */
     static std::unique_ptr<TransitionSystem> merge(
         const Labels &labels,
         const TransitionSystem &ts1,
         const TransitionSystem &ts2,
+        int num_threads,
         utils::LogProxy &log);
 
     /*
@@ -222,6 +256,9 @@ public:
       must be consistent with state_equivalence_relation in the sense that
       old states are only mapped to the same new state if they are in the same
       equivalence class as specified in state_equivalence_relation.
+
+      The transitions are mapped in place, so this only needs additional
+      memory for sorting the transitions of one local label at a time.
     */
     void apply_abstraction(
         const StateEquivalenceRelation &state_equivalence_relation,
@@ -244,6 +281,13 @@ public:
         return TransitionSystemConstIterator(local_label_infos.end(), local_label_infos.end());
     }
 
+    std::span<const Transition> get_transitions(
+        const LocalLabelInfo &local_label_info) const {
+        return std::span<const Transition>(transitions).subspan(
+            local_label_info.get_transitions_begin(),
+            local_label_info.get_num_transitions());
+    }
+
     /*
       Method to identify the transition system in output.
       Print "Atomic transition system #x: " for atomic transition systems,
@@ -67,6 +67,7 @@ bool shrink_factor(
     int new_size,
     int shrink_threshold_before_merge,
     const ShrinkStrategy &shrink_strategy,
+    int num_threads,
     utils::LogProxy &log) {
     /*
       TODO: think about factoring out common logic of this function and the
@@ -86,7 +87,8 @@ bool shrink_factor(
 
         const Distances &distances = fts.get_distances(index);
         StateEquivalenceRelation equivalence_relation =
-            shrink_strategy.compute_equivalence_relation(ts, distances, new_size, log);
+            shrink_strategy.compute_equivalence_relation(
+                ts, distances, new_size, num_threads, log);
         // TODO: We currently violate this; see issue250
         //assert(equivalence_relation.size() <= target_size);
         return fts.apply_abstraction(index, equivalence_relation, log);
@@ -102,6 +104,7 @@ bool shrink_before_merge_step(
     int max_states_before_merge,
     int shrink_threshold_before_merge,
     const ShrinkStrategy &shrink_strategy,
+    int num_threads,
     utils::LogProxy &log) {
     /*
       Compute the size limit for both transition systems as imposed by
@@ -126,6 +129,7 @@ bool shrink_before_merge_step(
         new_sizes.first,
         shrink_threshold_before_merge,
         shrink_strategy,
+        num_threads,
         log);
     if (shrunk1) {
         fts.statistics(index1, log);
@@ -136,6 +140,7 @@ bool shrink_before_merge_step(
         new_sizes.second,
         shrink_threshold_before_merge,
         shrink_strategy,
+        num_threads,
         log);
     if (shrunk2) {
         fts.statistics(index2, log);
@@ -44,7 +44,7 @@ extern std::pair<int, int> compute_shrink_sizes(
 
   If shrinking is triggered, apply the abstraction to the two factors
   within the factored transition system. Return true iff at least one of the
-  factors was shrunk.
+  factors was shrunk. The shrink strategy may use up to num_threads threads.
 */
 extern bool shrink_before_merge_step(
     FactoredTransitionSystem &fts,
@@ -54,6 +54,7 @@ extern bool shrink_before_merge_step(
     int max_states_before_merge,
     int shrink_threshold_before_merge,
     const ShrinkStrategy &shrink_strategy,
+    int num_threads,
     utils::LogProxy &log);
 
 /*
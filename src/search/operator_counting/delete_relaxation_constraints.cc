@@ -223,15 +223,22 @@ void DeleteRelaxationConstraints::initialize_constraints(
 
 bool DeleteRelaxationConstraints::update_constraints(
     const State &state, lp::LPSolver &lp_solver) {
-    // Unset old bounds.
-    for (FactPair f : last_state) {
-        lp_solver.set_constraint_lower_bound(get_constraint_id(f), 0);
+    if (last_state.empty()) {
+        for (FactProxy f : state) {
+            lp_solver.set_constraint_lower_bound(get_constraint_id(f.get_pair()), -1);
+            last_state.push_back(f.get_pair());
+        }
+        return false;
     }
-    last_state.clear();
-    // Set new bounds.
     for (FactProxy f : state) {
-        lp_solver.set_constraint_lower_bound(get_constraint_id(f.get_pair()), -1);
-        last_state.push_back(f.get_pair());
+        FactPair fact = f.get_pair();
+        FactPair &last_fact = last_state[fact.var];
+        if (fact != last_fact) {
+            // Unset old bound and set new bound.
+            lp_solver.set_constraint_lower_bound(get_constraint_id(last_fact), 0);
+            lp_solver.set_constraint_lower_bound(get_constraint_id(fact), -1);
+            last_fact = fact;
+        }
     }
     return false;
 }
@@ -49,7 +49,9 @@ class DeleteRelaxationConstraints : public ConstraintGenerator {
     std::vector<std::vector<int>> constraint_ids;
 
     /* The state that is currently used for setting the bounds. Remembering
-       this makes it faster to unset the bounds when the state changes. */
+       this makes it faster to unset the bounds when the state changes. We
+       only change the bounds of variables whose value changed, so that the
+       LP solver can reuse as much of its previous solution as possible. */
     std::vector<FactPair> last_state;
 
     int get_var_op_used(const OperatorProxy &op);
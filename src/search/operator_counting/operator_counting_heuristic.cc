@@ -6,6 +6,7 @@
 #include "../utils/markup.h"
 
 #include <cmath>
+#include <limits>
 
 using namespace std;
 
@@ -15,7 +16,12 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const plugins::Options &opt
       constraint_generators(
           opts.get_list<shared_ptr<ConstraintGenerator>>("constraint_generators")),
       lp_solver(opts.get<lp::LPSolverType>("lpsolver")),
-      use_integer_operator_counts(opts.get<bool>("use_integer_operator_counts")) {
+      use_integer_operator_counts(opts.get<bool>("use_integer_operator_counts")),
+      max_warm_start_bases(opts.get<int>("max_warm_start_bases")),
+      basis_ids(-1),
+      num_stored_bases(0),
+      last_start_basis_id(-1),
+      last_basis_id(-1) {
     lp_solver.set_mip_gap(0);
     named_vector::NamedVector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
@@ -33,9 +39,69 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const plugins::Options &opt
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
 }
 
+bool OperatorCountingHeuristic::use_warm_starts() const {
+    // MIP solvers do not use bases, so we only warm-start LPs.
+    return max_warm_start_bases > 0 && !use_integer_operator_counts;
+}
+
+const lp::LPBasis *OperatorCountingHeuristic::get_basis(int basis_id) const {
+    if (basis_id < 0 || basis_id < num_stored_bases - max_warm_start_bases) {
+        // The basis was never stored or has already been overwritten.
+        return nullptr;
+    }
+    return &bases[basis_id % max_warm_start_bases];
+}
+
+int OperatorCountingHeuristic::store_basis(lp::LPBasis &&basis) {
+    if (num_stored_bases == numeric_limits<int>::max()) {
+        // Stop warm-starting instead of letting basis numbers overflow.
+        return -1;
+    }
+    int basis_id = num_stored_bases++;
+    int slot = basis_id % max_warm_start_bases;
+    if (slot == static_cast<int>(bases.size())) {
+        bases.push_back(move(basis));
+    } else {
+        bases[slot] = move(basis);
+    }
+    return basis_id;
+}
+
+void OperatorCountingHeuristic::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    if (use_warm_starts()) {
+        evals.insert(this);
+    }
+}
+
+void OperatorCountingHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID, const State &state) {
+    /*
+      Until the state is evaluated, it starts from the basis of its parent.
+      States that already have their own basis keep it.
+    */
+    int &basis_id = basis_ids[state];
+    if (basis_id == -1) {
+        basis_id = basis_ids[parent_state];
+    }
+}
+
 int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     assert(!lp_solver.has_temporary_constraints());
+    bool warm_start = use_warm_starts() && ancestor_state.get_registry();
+    if (warm_start) {
+        int parent_basis_id = basis_ids[ancestor_state];
+        if (parent_basis_id != last_start_basis_id &&
+            parent_basis_id != last_basis_id) {
+            const lp::LPBasis *basis = get_basis(parent_basis_id);
+            if (basis) {
+                lp_solver.set_basis(*basis);
+            }
+        }
+        last_start_basis_id = parent_basis_id;
+        last_basis_id = -1;
+    }
     for (const auto &generator : constraint_generators) {
         bool dead_end = generator->update_constraints(state, lp_solver);
         if (dead_end) {
@@ -49,6 +115,10 @@ int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
         double epsilon = 0.01;
         double objective_value = lp_solver.get_objective_value();
         result = static_cast<int>(ceil(objective_value - epsilon));
+        if (warm_start) {
+            last_basis_id = store_basis(lp_solver.get_basis());
+            basis_ids[ancestor_state] = last_basis_id;
+        }
     } else {
         result = DEAD_END;
     }
@@ -90,6 +160,17 @@ public:
             "computationally expensive. Turning this option on can thus drastically "
             "increase the runtime.",
             "false");
+        add_option<int>(
+            "max_warm_start_bases",
+            "number of optimal LP bases that are kept to warm-start the LPs of "
+            "successor states. The LP of a state is solved starting from the "
+            "basis of the parent state that generated it (if the basis is "
+            "still stored), which usually needs far fewer simplex iterations "
+            "than solving the LP from scratch. Each basis uses memory linear in "
+            "the size of the LP. Use 0 to disable warm starts. Warm starts are "
+            "not used with integer operator counts.",
+            "1000",
+            plugins::Bounds("0", "infinity"));
         lp::add_lp_solver_option_to_feature(*this);
         Heuristic::add_options_to_feature(*this);
 
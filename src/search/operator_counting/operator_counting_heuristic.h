@@ -3,6 +3,8 @@
 
 #include "../heuristic.h"
 
+#include "../per_state_information.h"
+
 #include "../lp/lp_solver.h"
 
 #include <memory>
@@ -19,11 +21,42 @@ class OperatorCountingHeuristic : public Heuristic {
     std::vector<std::shared_ptr<ConstraintGenerator>> constraint_generators;
     lp::LPSolver lp_solver;
     const bool use_integer_operator_counts;
+
+    /*
+      We warm-start the LP of a state from the optimal basis of its parent
+      state. The last max_warm_start_bases bases are kept in a ring buffer
+      and basis_ids maps each state to the number of its own basis (once
+      the state is evaluated) or to the number of its parent's basis (until
+      then). Basis number i lives in bases[i % max_warm_start_bases] and is
+      overwritten by basis number i + max_warm_start_bases.
+    */
+    const int max_warm_start_bases;
+    PerStateInformation<int> basis_ids;
+    std::vector<lp::LPBasis> bases;
+    int num_stored_bases;
+    /*
+      The basis that the previous LP was started from and the basis it
+      ended in. If the current state is a sibling or a child of the
+      previous state, the solver's basis is already close to the parent's,
+      so we skip loading the basis.
+    */
+    int last_start_basis_id;
+    int last_basis_id;
+
+    bool use_warm_starts() const;
+    const lp::LPBasis *get_basis(int basis_id) const;
+    int store_basis(lp::LPBasis &&basis);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit OperatorCountingHeuristic(const plugins::Options &opts);
     ~OperatorCountingHeuristic();
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override;
+    virtual void notify_state_transition(
+        const State &parent_state, OperatorID op_id,
+        const State &state) override;
 };
 }
 
@@ -50,6 +50,7 @@ void PhOConstraints::initialize_constraints(
 bool PhOConstraints::update_constraints(const State &state,
                                         lp::LPSolver &lp_solver) {
     state.unpack();
+    last_bounds.resize(pdbs->size(), -1);
     for (size_t i = 0; i < pdbs->size(); ++i) {
         int constraint_id = constraint_offset + i;
         shared_ptr<pdbs::PatternDatabase> pdb = (*pdbs)[i];
@@ -57,7 +58,10 @@ bool PhOConstraints::update_constraints(const State &state,
         if (h == numeric_limits<int>::max()) {
             return true;
         }
-        lp_solver.set_constraint_lower_bound(constraint_id, h);
+        if (h != last_bounds[i]) {
+            lp_solver.set_constraint_lower_bound(constraint_id, h);
+            last_bounds[i] = h;
+        }
     }
     return false;
 }
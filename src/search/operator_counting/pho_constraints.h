@@ -8,6 +8,7 @@
 #include "../pdbs/types.h"
 
 #include <memory>
+#include <vector>
 
 namespace plugins {
 class Options;
@@ -23,6 +24,8 @@ class PhOConstraints : public ConstraintGenerator {
 
     int constraint_offset;
     std::shared_ptr<pdbs::PDBCollection> pdbs;
+    // Bounds that were last set in the LP (-1 if none was set yet).
+    std::vector<int> last_bounds;
 public:
     explicit PhOConstraints(const plugins::Options &opts);
 
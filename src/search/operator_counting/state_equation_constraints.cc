@@ -94,7 +94,14 @@ void StateEquationConstraints::initialize_constraints(
 bool StateEquationConstraints::update_constraints(const State &state,
                                                   lp::LPSolver &lp_solver) {
     // Compute the bounds for the rows in the LP.
+    bool first_state = last_state.empty();
+    last_state.resize(propositions.size(), -1);
     for (size_t var = 0; var < propositions.size(); ++var) {
+        int state_value = state[var].get_value();
+        if (!first_state && last_state[var] == state_value) {
+            continue;
+        }
+        last_state[var] = state_value;
         int num_values = propositions[var].size();
         for (int value = 0; value < num_values; ++value) {
             const Proposition &prop = propositions[var][value];
@@ -103,7 +110,7 @@ bool StateEquationConstraints::update_constraints(const State &state,
                 double lower_bound = 0;
                 /* If we consider the current value of var, there must be an
                    additional consumer. */
-                if (state[var].get_value() == value) {
+                if (state_value == value) {
                     --lower_bound;
                 }
                 /* If we consider the goal value of var, there must be an
@@ -36,6 +36,10 @@ class StateEquationConstraints : public ConstraintGenerator {
     std::vector<std::vector<Proposition>> propositions;
     // Map goal variables to their goal value and other variables to max int.
     std::vector<int> goal_state;
+    /* Values of the state that the bounds were last set for. We only update
+       the bounds of variables whose value changed, so that the LP solver
+       can reuse as much of its previous solution as possible. */
+    std::vector<int> last_state;
 
     void build_propositions(const TaskProxy &task_proxy);
     void add_constraints(named_vector::NamedVector<lp::LPConstraint> &constraints, double infinity);
@@ -16,13 +16,24 @@
 using namespace std;
 
 namespace parser {
+/*
+  Constructing the registry creates the types of all plugins, which can only
+  happen once. We therefore share the registry between all parses, e.g.,
+  when evaluator configurations are parsed again to create copies.
+*/
+static const plugins::Registry &get_registry() {
+    static const plugins::Registry registry =
+        plugins::RawRegistry::instance()->construct_registry();
+    return registry;
+}
+
 class DecorateContext : public utils::Context {
-    const plugins::Registry registry;
+    const plugins::Registry &registry;
     unordered_map<string, const plugins::Type *> variables;
 
 public:
     DecorateContext()
-        : registry(plugins::RawRegistry::instance()->construct_registry()) {
+        : registry(parser::get_registry()) {
     }
 
     void add_variable(const string &name, const plugins::Type &type) {
@@ -419,6 +430,8 @@ DecoratedASTNodePtr LiteralNode::decorate(DecorateContext &context) const {
     switch (value.type) {
     case TokenType::BOOLEAN:
         return utils::make_unique_ptr<BoolLiteralNode>(value.content);
+    case TokenType::STRING:
+        return utils::make_unique_ptr<StringLiteralNode>(value.content);
     case TokenType::INTEGER:
         return utils::make_unique_ptr<IntLiteralNode>(value.content);
     case TokenType::FLOAT:
@@ -440,6 +453,8 @@ const plugins::Type &LiteralNode::get_type(DecorateContext &context) const {
     switch (value.type) {
     case TokenType::BOOLEAN:
         return plugins::TypeRegistry::instance()->get_type<bool>();
+    case TokenType::STRING:
+        return plugins::TypeRegistry::instance()->get_type<string>();
     case TokenType::INTEGER:
         return plugins::TypeRegistry::instance()->get_type<int>();
     case TokenType::FLOAT:
@@ -29,6 +29,7 @@ static vector<pair<TokenType, regex>> construct_token_type_expressions() {
         {TokenType::INTEGER,
          R"([+-]?(infinity|\d+([kmg]\b)?))"},
         {TokenType::BOOLEAN, R"(true|false)"},
+        {TokenType::STRING, R"("[^"]*")"},
         {TokenType::LET, R"(let)"},
         {TokenType::IDENTIFIER, R"([a-zA-Z_]\w*)"}
     };
@@ -59,7 +60,12 @@ TokenStream split_tokens(const string &text) {
             TokenType token_type = type_and_expression.first;
             const regex &expression = type_and_expression.second;
             if (regex_search(start, end, match, expression)) {
-                tokens.push_back({utils::tolower(match[1]), token_type});
+                // Strings (e.g., file names) are case-sensitive.
+                string content = match[1];
+                if (token_type != TokenType::STRING) {
+                    content = utils::tolower(content);
+                }
+                tokens.push_back({content, token_type});
                 start += match[0].length();
                 has_match = true;
                 break;
@@ -71,19 +71,19 @@ template<class Element>
 class PerStateArray : public subscriber::Subscriber<StateRegistry> {
     const std::vector<Element> default_array;
     using EntryArrayVectorMap = std::unordered_map<const StateRegistry *,
-                                                   segmented_vector::SegmentedArrayVector<Element> *>;
+                                                   StateDataArrayVector<Element> *>;
     EntryArrayVectorMap entry_arrays_by_registry;
 
     mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedArrayVector<Element> *cached_entries;
+    mutable StateDataArrayVector<Element> *cached_entries;
 
-    segmented_vector::SegmentedArrayVector<Element> *get_entries(const StateRegistry *registry) {
+    StateDataArrayVector<Element> *get_entries(const StateRegistry *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedArrayVector<Element>(
-                    default_array.size());
+                cached_entries = new StateDataArrayVector<Element>(
+                    default_array.size(), registry->get_memory_resource());
                 entry_arrays_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -94,7 +94,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
         return cached_entries;
     }
 
-    const segmented_vector::SegmentedArrayVector<Element> *get_entries(
+    const StateDataArrayVector<Element> *get_entries(
         const StateRegistry *registry) const {
         if (cached_registry != registry) {
             const auto it = entry_arrays_by_registry.find(registry);
@@ -102,7 +102,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedArrayVector<Element> *>(
+                cached_entries = const_cast<StateDataArrayVector<Element> *>(
                     it->second);
             }
         }
@@ -133,7 +133,7 @@ public:
                       << "state." << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
-        segmented_vector::SegmentedArrayVector<Element> *entries = get_entries(registry);
+        StateDataArrayVector<Element> *entries = get_entries(registry);
         int state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
         size_t virtual_size = registry->size();
@@ -151,7 +151,7 @@ public:
                       << "state." << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
-        const segmented_vector::SegmentedArrayVector<Element> *entries =
+        const StateDataArrayVector<Element> *entries =
             get_entries(registry);
         if (!entries) {
             ABORT("PerStateArray::operator[] const tried to access "
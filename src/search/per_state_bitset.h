@@ -38,6 +38,16 @@ public:
 
     bool test(int index) const;
     int size() const;
+
+    /* Access whole blocks for word-wise operations. Bits beyond size()
+       in the last block are always unset. */
+    int get_num_blocks() const {
+        return data.size();
+    }
+
+    BitsetMath::Block get_block(int block_index) const {
+        return data[block_index];
+    }
 };
 
 
@@ -62,6 +72,16 @@ public:
     bool test(int index) const;
     void intersect(const BitsetView &other);
     int size() const;
+
+    /* Access whole blocks for word-wise operations. Callers must not set
+       bits beyond size() in the last block. */
+    int get_num_blocks() const {
+        return data.size();
+    }
+
+    BitsetMath::Block &get_block(int block_index) {
+        return data[block_index];
+    }
 };
 
 
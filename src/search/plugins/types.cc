@@ -294,6 +294,9 @@ TypeRegistry::TypeRegistry() {
     insert_basic_type<bool>();
     insert_basic_type<int>();
     insert_basic_type<double>();
+    // Use a readable name instead of the compiler-specific name of std::string.
+    registered_types[typeid(string)] =
+        utils::make_unique_ptr<BasicType>(typeid(string), "string");
 }
 
 template<typename T>
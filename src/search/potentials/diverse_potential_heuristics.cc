@@ -19,6 +19,7 @@ DiversePotentialHeuristics::DiversePotentialHeuristics(const plugins::Options &o
     : optimizer(opts),
       max_num_heuristics(opts.get<int>("max_num_heuristics")),
       num_samples(opts.get<int>("num_samples")),
+      num_threads(opts.get<int>("threads")),
       rng(utils::parse_rng_from_options(opts)),
       log(utils::get_log_from_options(opts)) {
 }
@@ -27,21 +28,23 @@ SamplesToFunctionsMap
 DiversePotentialHeuristics::filter_samples_and_compute_functions(
     const vector<State> &samples) {
     utils::Timer filtering_timer;
-    utils::HashSet<State> dead_ends;
-    int num_duplicates = 0;
-    int num_dead_ends = 0;
-    SamplesToFunctionsMap samples_to_functions;
+    // Skipping duplicates is not necessary, but saves LP evaluations.
+    utils::HashSet<State> unique_samples_set;
+    vector<State> unique_samples;
     for (const State &sample : samples) {
-        // Skipping duplicates is not necessary, but saves LP evaluations.
-        if (samples_to_functions.count(sample) || dead_ends.count(sample)) {
-            ++num_duplicates;
-            continue;
+        if (unique_samples_set.insert(sample).second) {
+            unique_samples.push_back(sample);
         }
-        optimizer.optimize_for_state(sample);
-        if (optimizer.has_optimal_solution()) {
-            samples_to_functions[sample] = optimizer.get_potential_function();
+    }
+    int num_duplicates = samples.size() - unique_samples.size();
+    vector<unique_ptr<PotentialFunction>> functions =
+        optimizer.optimize_for_each_sample(unique_samples, num_threads);
+    int num_dead_ends = 0;
+    SamplesToFunctionsMap samples_to_functions;
+    for (size_t i = 0; i < unique_samples.size(); ++i) {
+        if (functions[i]) {
+            samples_to_functions[unique_samples[i]] = move(functions[i]);
         } else {
-            dead_ends.insert(sample);
             ++num_dead_ends;
         }
     }
@@ -162,6 +165,7 @@ public:
             "maximum number of potential heuristics",
             "infinity",
             plugins::Bounds("0", "infinity"));
+        add_threads_option_for_potentials(*this);
         prepare_parser_for_admissible_potentials(*this);
         utils::add_rng_options(*this);
     }
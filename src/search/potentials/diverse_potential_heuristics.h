@@ -30,6 +30,7 @@ class DiversePotentialHeuristics {
     // with num_samples parameter?
     const int max_num_heuristics;
     const int num_samples;
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
     utils::LogProxy log;
     std::vector<std::unique_ptr<PotentialFunction>> diverse_functions;
@@ -6,6 +6,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <limits>
@@ -22,7 +23,8 @@ static int get_undefined_value(VariableProxy var) {
 PotentialOptimizer::PotentialOptimizer(const plugins::Options &opts)
     : task(opts.get<shared_ptr<AbstractTask>>("transform")),
       task_proxy(*task),
-      lp_solver(opts.get<lp::LPSolverType>("lpsolver")),
+      lp_solver_type(opts.get<lp::LPSolverType>("lpsolver")),
+      lp_solver(lp_solver_type),
       max_potential(opts.get<double>("max_potential")),
       num_lp_vars(0) {
     task_properties::verify_no_axioms(task_proxy);
@@ -42,7 +44,8 @@ void PotentialOptimizer::initialize() {
         }
         fact_potentials[var.get_id()].resize(var.get_domain_size());
     }
-    construct_lp();
+    lp_solver.load_problem(construct_lp());
+    objective.assign(num_lp_vars, 1.0);
 }
 
 bool PotentialOptimizer::has_optimal_solution() const {
@@ -71,7 +74,7 @@ void PotentialOptimizer::optimize_for_all_states() {
     for (FactProxy fact : task_proxy.get_variables().get_facts()) {
         coefficients[get_lp_var_id(fact)] = 1.0 / fact.get_variable().get_domain_size();
     }
-    lp_solver.set_objective_coefficients(coefficients);
+    set_objective(coefficients);
     solve_and_extract();
     if (!has_optimal_solution()) {
         ABORT("all-states LP unbounded even though potentials are bounded.");
@@ -85,10 +88,89 @@ void PotentialOptimizer::optimize_for_samples(const vector<State> &samples) {
             coefficients[get_lp_var_id(fact)] += 1.0;
         }
     }
-    lp_solver.set_objective_coefficients(coefficients);
+    set_objective(coefficients);
     solve_and_extract();
 }
 
+vector<int> PotentialOptimizer::compute_sample_matrix(
+    const vector<State> &samples) const {
+    // Row i holds the LP variables of the facts of sample i.
+    int num_vars = task_proxy.get_variables().size();
+    vector<int> sample_matrix;
+    sample_matrix.reserve(samples.size() * num_vars);
+    for (const State &sample : samples) {
+        for (FactProxy fact : sample) {
+            sample_matrix.push_back(get_lp_var_id(fact));
+        }
+    }
+    return sample_matrix;
+}
+
+void PotentialOptimizer::optimize_for_sample_range(
+    lp::LPSolver &solver, vector<double> &solver_objective,
+    const vector<int> &sample_matrix, int begin, int end,
+    vector<unique_ptr<PotentialFunction>> &functions) const {
+    int num_vars = lp_var_ids.size();
+    for (int sample_id = begin; sample_id < end; ++sample_id) {
+        const int *row = &sample_matrix[sample_id * num_vars];
+        if (sample_id == begin) {
+            solver_objective.assign(num_lp_vars, 0.0);
+            for (int var = 0; var < num_vars; ++var) {
+                solver_objective[row[var]] = 1.0;
+            }
+            solver.set_objective_coefficients(solver_objective);
+        } else {
+            const int *previous_row = row - num_vars;
+            for (int var = 0; var < num_vars; ++var) {
+                if (row[var] != previous_row[var]) {
+                    solver_objective[previous_row[var]] = 0.0;
+                    solver.set_objective_coefficient(previous_row[var], 0.0);
+                    solver_objective[row[var]] = 1.0;
+                    solver.set_objective_coefficient(row[var], 1.0);
+                }
+            }
+        }
+        solver.solve();
+        if (solver.has_optimal_solution()) {
+            functions[sample_id] = utils::make_unique_ptr<PotentialFunction>(
+                extract_fact_potentials(solver));
+        }
+    }
+}
+
+vector<unique_ptr<PotentialFunction>> PotentialOptimizer::optimize_for_each_sample(
+    const vector<State> &samples, int num_threads) {
+    int num_samples = samples.size();
+    vector<unique_ptr<PotentialFunction>> functions(num_samples);
+    if (samples.empty()) {
+        return functions;
+    }
+    vector<int> sample_matrix = compute_sample_matrix(samples);
+    int num_ranges = min(num_threads, num_samples);
+    if (static_cast<int>(helper_lp_solvers.size()) < num_ranges - 1) {
+        lp::LinearProgram lp = construct_lp();
+        while (static_cast<int>(helper_lp_solvers.size()) < num_ranges - 1) {
+            helper_lp_solvers.push_back(
+                utils::make_unique_ptr<lp::LPSolver>(lp_solver_type));
+            helper_lp_solvers.back()->load_problem(lp);
+        }
+    }
+    utils::parallel_for(num_threads, num_ranges, [&](int range) {
+            int begin = static_cast<long long>(num_samples) * range / num_ranges;
+            int end = static_cast<long long>(num_samples) * (range + 1) / num_ranges;
+            if (range == 0) {
+                optimize_for_sample_range(
+                    lp_solver, objective, sample_matrix, begin, end, functions);
+            } else {
+                vector<double> helper_objective;
+                optimize_for_sample_range(
+                    *helper_lp_solvers[range - 1], helper_objective,
+                    sample_matrix, begin, end, functions);
+            }
+        });
+    return functions;
+}
+
 const shared_ptr<AbstractTask> PotentialOptimizer::get_task() const {
     return task;
 }
@@ -97,7 +179,23 @@ bool PotentialOptimizer::potentials_are_bounded() const {
     return max_potential != numeric_limits<double>::infinity();
 }
 
-void PotentialOptimizer::construct_lp() {
+void PotentialOptimizer::set_objective(const vector<double> &new_objective) {
+    /*
+      Only pass on the coefficients that changed. The solvers keep their
+      basis when the objective changes, so the next solve starts from the
+      optimal basis for the previous objective.
+    */
+    assert(new_objective.size() == objective.size());
+    for (int lp_var_id = 0; lp_var_id < num_lp_vars; ++lp_var_id) {
+        if (new_objective[lp_var_id] != objective[lp_var_id]) {
+            lp_solver.set_objective_coefficient(
+                lp_var_id, new_objective[lp_var_id]);
+        }
+    }
+    objective = new_objective;
+}
+
+lp::LinearProgram PotentialOptimizer::construct_lp() const {
     double infinity = lp_solver.get_infinity();
     double upper_bound = (potentials_are_bounded() ? max_potential : infinity);
 
@@ -182,9 +280,8 @@ void PotentialOptimizer::construct_lp() {
             lp_constraints.push_back(constraint);
         }
     }
-    lp::LinearProgram lp(lp::LPObjectiveSense::MAXIMIZE, move(lp_variables),
-                         move(lp_constraints), infinity);
-    lp_solver.load_problem(lp);
+    return lp::LinearProgram(lp::LPObjectiveSense::MAXIMIZE, move(lp_variables),
+                             move(lp_constraints), infinity);
 }
 
 void PotentialOptimizer::solve_and_extract() {
@@ -196,11 +293,23 @@ void PotentialOptimizer::solve_and_extract() {
 
 void PotentialOptimizer::extract_lp_solution() {
     assert(has_optimal_solution());
-    const vector<double> solution = lp_solver.extract_solution();
-    for (FactProxy fact : task_proxy.get_variables().get_facts()) {
-        fact_potentials[fact.get_variable().get_id()][fact.get_value()] =
-            solution[get_lp_var_id(fact)];
+    fact_potentials = extract_fact_potentials(lp_solver);
+}
+
+vector<vector<double>> PotentialOptimizer::extract_fact_potentials(
+    const lp::LPSolver &solver) const {
+    // Only use lp_var_ids here since other threads may call this function.
+    const vector<double> solution = solver.extract_solution();
+    vector<vector<double>> potentials(lp_var_ids.size());
+    for (size_t var = 0; var < lp_var_ids.size(); ++var) {
+        // The last LP variable of each variable is for the "undefined" value.
+        int domain_size = lp_var_ids[var].size() - 1;
+        potentials[var].resize(domain_size);
+        for (int value = 0; value < domain_size; ++value) {
+            potentials[var][value] = solution[lp_var_ids[var][value]];
+        }
     }
+    return potentials;
 }
 
 unique_ptr<PotentialFunction> PotentialOptimizer::get_potential_function() const {
@@ -44,17 +44,34 @@ class PotentialFunction;
 class PotentialOptimizer {
     std::shared_ptr<AbstractTask> task;
     TaskProxy task_proxy;
+    lp::LPSolverType lp_solver_type;
     lp::LPSolver lp_solver;
     const double max_potential;
     int num_lp_vars;
     std::vector<std::vector<int>> lp_var_ids;
     std::vector<std::vector<double>> fact_potentials;
+    // Objective coefficients currently loaded into lp_solver.
+    std::vector<double> objective;
+    /*
+      Additional solvers with the same LP for optimizing for individual
+      samples in parallel. They are created on demand.
+    */
+    std::vector<std::unique_ptr<lp::LPSolver>> helper_lp_solvers;
 
     int get_lp_var_id(const FactProxy &fact) const;
     void initialize();
-    void construct_lp();
+    lp::LinearProgram construct_lp() const;
+    void set_objective(const std::vector<double> &new_objective);
     void solve_and_extract();
     void extract_lp_solution();
+    std::vector<std::vector<double>> extract_fact_potentials(
+        const lp::LPSolver &solver) const;
+    std::vector<int> compute_sample_matrix(
+        const std::vector<State> &samples) const;
+    void optimize_for_sample_range(
+        lp::LPSolver &solver, std::vector<double> &solver_objective,
+        const std::vector<int> &sample_matrix, int begin, int end,
+        std::vector<std::unique_ptr<PotentialFunction>> &functions) const;
 
 public:
     explicit PotentialOptimizer(const plugins::Options &opts);
@@ -67,6 +84,22 @@ public:
     void optimize_for_all_states();
     void optimize_for_samples(const std::vector<State> &samples);
 
+    /*
+      Compute a potential function optimized for each sample individually.
+      The entry for a sample is nullptr if its LP has no optimal solution,
+      e.g., because the sample is a dead end. The samples are split into
+      consecutive ranges and each range is handled by a separate thread
+      with its own LP solver. Within a range, we only change the objective
+      coefficients of facts that differ between consecutive samples and
+      start each solve from the previous optimal basis.
+
+      Afterwards, the solution of the main LP is undefined, i.e.,
+      has_optimal_solution() and get_potential_function() may only be
+      used after optimizing for another objective.
+    */
+    std::vector<std::unique_ptr<PotentialFunction>> optimize_for_each_sample(
+        const std::vector<State> &samples, int num_threads);
+
     bool has_optimal_solution() const;
 
     std::unique_ptr<PotentialFunction> get_potential_function() const;
@@ -13,13 +13,15 @@
 using namespace std;
 
 namespace potentials {
-static void filter_dead_ends(PotentialOptimizer &optimizer, vector<State> &samples) {
+static void filter_dead_ends(
+    PotentialOptimizer &optimizer, vector<State> &samples, int num_threads) {
     assert(!optimizer.potentials_are_bounded());
+    vector<unique_ptr<PotentialFunction>> functions =
+        optimizer.optimize_for_each_sample(samples, num_threads);
     vector<State> non_dead_end_samples;
-    for (const State &sample : samples) {
-        optimizer.optimize_for_state(sample);
-        if (optimizer.has_optimal_solution())
-            non_dead_end_samples.push_back(sample);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (functions[i])
+            non_dead_end_samples.push_back(samples[i]);
     }
     swap(samples, non_dead_end_samples);
 }
@@ -27,11 +29,12 @@ static void filter_dead_ends(PotentialOptimizer &optimizer, vector<State> &sampl
 static void optimize_for_samples(
     PotentialOptimizer &optimizer,
     int num_samples,
+    int num_threads,
     utils::RandomNumberGenerator &rng) {
     vector<State> samples = sample_without_dead_end_detection(
         optimizer, num_samples, rng);
     if (!optimizer.potentials_are_bounded()) {
-        filter_dead_ends(optimizer, samples);
+        filter_dead_ends(optimizer, samples, num_threads);
     }
     optimizer.optimize_for_samples(samples);
 }
@@ -46,7 +49,9 @@ static vector<unique_ptr<PotentialFunction>> create_sample_based_potential_funct
     PotentialOptimizer optimizer(opts);
     shared_ptr<utils::RandomNumberGenerator> rng(utils::parse_rng_from_options(opts));
     for (int i = 0; i < opts.get<int>("num_heuristics"); ++i) {
-        optimize_for_samples(optimizer, opts.get<int>("num_samples"), *rng);
+        optimize_for_samples(
+            optimizer, opts.get<int>("num_samples"), opts.get<int>("threads"),
+            *rng);
         functions.push_back(optimizer.get_potential_function());
     }
     return functions;
@@ -70,6 +75,7 @@ public:
             "Number of states to sample",
             "1000",
             plugins::Bounds("0", "infinity"));
+        add_threads_option_for_potentials(*this);
         prepare_parser_for_admissible_potentials(*this);
         utils::add_rng_options(*this);
     }
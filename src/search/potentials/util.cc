@@ -44,6 +44,18 @@ string get_admissible_potentials_reference() {
         "2015");
 }
 
+void add_threads_option_for_potentials(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "threads",
+        "Number of threads for computing the potential functions optimized "
+        "for individual samples, e.g., for detecting dead-end samples. "
+        "Each thread uses its own LP solver. Since the LPs often have "
+        "multiple optimal solutions, the number of threads can affect which "
+        "potential functions are found.",
+        "1",
+        plugins::Bounds("1", "infinity"));
+}
+
 void prepare_parser_for_admissible_potentials(plugins::Feature &feature) {
     feature.document_language_support("action costs", "supported");
     feature.document_language_support("conditional effects", "not supported");
@@ -24,6 +24,7 @@ std::vector<State> sample_without_dead_end_detection(
     utils::RandomNumberGenerator &rng);
 
 std::string get_admissible_potentials_reference();
+void add_threads_option_for_potentials(plugins::Feature &feature);
 void prepare_parser_for_admissible_potentials(plugins::Feature &feature);
 }
 
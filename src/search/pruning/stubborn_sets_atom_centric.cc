@@ -3,16 +3,23 @@
 #include "../plugins/plugin.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/collections.h"
 
 #include <limits>
 
 using namespace std;
 
 namespace stubborn_sets_atom_centric {
+static const int64_t NUM_LOOKUPS_BEFORE_CHECKING_CACHE = 1000;
+
 StubbornSetsAtomCentric::StubbornSetsAtomCentric(const plugins::Options &opts)
     : StubbornSets(opts),
       use_sibling_shortcut(opts.get<bool>("use_sibling_shortcut")),
-      atom_selection_strategy(opts.get<AtomSelectionStrategy>("atom_selection_strategy")) {
+      atom_selection_strategy(opts.get<AtomSelectionStrategy>("atom_selection_strategy")),
+      max_cache_size(opts.get<int>("max_cache_size")),
+      use_cache(max_cache_size > 0),
+      num_cache_hits(0),
+      num_cache_misses(0) {
 }
 
 void StubbornSetsAtomCentric::initialize(const shared_ptr<AbstractTask> &task) {
@@ -35,6 +42,7 @@ void StubbornSetsAtomCentric::initialize(const shared_ptr<AbstractTask> &task) {
     }
 
     compute_consumers(task_proxy);
+    variable_is_read.resize(num_variables, false);
 }
 
 void StubbornSetsAtomCentric::compute_consumers(const TaskProxy &task_proxy) {
@@ -58,8 +66,26 @@ void StubbornSetsAtomCentric::compute_consumers(const TaskProxy &task_proxy) {
     }
 }
 
-bool StubbornSetsAtomCentric::operator_is_applicable(int op, const State &state) const {
-    return find_unsatisfied_precondition(op, state) == FactPair::no_fact;
+int StubbornSetsAtomCentric::get_value(const State &state, int var) {
+    if (use_cache && !variable_is_read[var]) {
+        variable_is_read[var] = true;
+        read_variables.push_back(var);
+    }
+    return state[var].get_value();
+}
+
+FactPair StubbornSetsAtomCentric::find_unsatisfied_condition(
+    const vector<FactPair> &conditions, const State &state) {
+    for (const FactPair &condition : conditions) {
+        if (get_value(state, condition.var) != condition.value)
+            return condition;
+    }
+    return FactPair::no_fact;
+}
+
+bool StubbornSetsAtomCentric::operator_is_applicable(int op, const State &state) {
+    return find_unsatisfied_condition(sorted_op_preconditions[op], state) ==
+           FactPair::no_fact;
 }
 
 void StubbornSetsAtomCentric::enqueue_producers(const FactPair &fact) {
@@ -125,17 +151,17 @@ void StubbornSetsAtomCentric::enqueue_sibling_consumers(const FactPair &fact) {
 }
 
 FactPair StubbornSetsAtomCentric::select_fact(
-    const vector<FactPair> &facts, const State &state) const {
+    const vector<FactPair> &facts, const State &state) {
     FactPair fact = FactPair::no_fact;
     if (atom_selection_strategy == AtomSelectionStrategy::FAST_DOWNWARD) {
-        fact = stubborn_sets::find_unsatisfied_condition(facts, state);
+        fact = find_unsatisfied_condition(facts, state);
     } else if (atom_selection_strategy == AtomSelectionStrategy::QUICK_SKIP) {
         /*
           If there is an unsatisfied fact whose producers are already marked,
           choose it. Otherwise, choose the first unsatisfied fact.
         */
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
+            if (get_value(state, condition.var) != condition.value) {
                 if (marked_producers[condition.var][condition.value]) {
                     fact = condition;
                     break;
@@ -147,7 +173,7 @@ FactPair StubbornSetsAtomCentric::select_fact(
     } else if (atom_selection_strategy == AtomSelectionStrategy::STATIC_SMALL) {
         int min_count = numeric_limits<int>::max();
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
+            if (get_value(state, condition.var) != condition.value) {
                 int count = achievers[condition.var][condition.value].size();
                 if (count < min_count) {
                     fact = condition;
@@ -158,7 +184,7 @@ FactPair StubbornSetsAtomCentric::select_fact(
     } else if (atom_selection_strategy == AtomSelectionStrategy::DYNAMIC_SMALL) {
         int min_count = numeric_limits<int>::max();
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
+            if (get_value(state, condition.var) != condition.value) {
                 const vector<int> &ops = achievers[condition.var][condition.value];
                 int count = count_if(
                     ops.begin(), ops.end(), [&](int op) {return !stubborn[op];});
@@ -194,7 +220,7 @@ void StubbornSetsAtomCentric::enqueue_interferers(int op) {
     }
 }
 
-void StubbornSetsAtomCentric::compute_stubborn_set(const State &state) {
+void StubbornSetsAtomCentric::compute_uncached_stubborn_set(const State &state) {
     assert(producer_queue.empty());
     assert(consumer_queue.empty());
     // Reset data structures from previous call.
@@ -235,6 +261,7 @@ void StubbornSetsAtomCentric::handle_stubborn_operator(const State &state, int o
     if (!stubborn[op]) {
         stubborn[op] = true;
         if (operator_is_applicable(op, state)) {
+            applicable_stubborn_operators.push_back(op);
             enqueue_interferers(op);
         } else {
             enqueue_nes(op, state);
@@ -242,6 +269,112 @@ void StubbornSetsAtomCentric::handle_stubborn_operator(const State &state, int o
     }
 }
 
+bool StubbornSetsAtomCentric::lookup_cached_stubborn_set(
+    const State &state, int &node, int &depth) {
+    node = cache_nodes.empty() ? -1 : 0;
+    depth = 0;
+    while (node != -1 && cache_nodes[node].var != -1) {
+        int var = cache_nodes[node].var;
+        auto it = cache_edges.find(make_pair(node, state[var].get_value()));
+        if (it == cache_edges.end())
+            return false;
+        node = it->second;
+        ++depth;
+    }
+    if (node == -1)
+        return false;
+    for (int op : cached_stubborn_operators[cache_nodes[node].result]) {
+        stubborn[op] = true;
+    }
+    return true;
+}
+
+void StubbornSetsAtomCentric::insert_into_cache(
+    const State &state, int node, int depth) {
+    int result = cached_stubborn_operators.size();
+    cached_stubborn_operators.push_back(applicable_stubborn_operators);
+    int num_reads = read_variables.size();
+    // Add the node reached after the given number of reads.
+    auto add_node = [&](int num_previous_reads) {
+        if (num_previous_reads < num_reads) {
+            cache_nodes.push_back({read_variables[num_previous_reads], -1});
+        } else {
+            cache_nodes.push_back({-1, result});
+        }
+        return static_cast<int>(cache_nodes.size()) - 1;
+    };
+
+    /*
+      The lookup followed the path of the first depth reads and failed at
+      the given node, so the rest of the path is new.
+    */
+    if (node == -1) {
+        assert(depth == 0);
+        node = add_node(0);
+    }
+    for (int i = depth; i < num_reads; ++i) {
+        int var = read_variables[i];
+        assert(cache_nodes[node].var == var);
+        int child = add_node(i + 1);
+        cache_edges.emplace(make_pair(node, state[var].get_value()), child);
+        node = child;
+    }
+    assert(cache_nodes[node].result == result);
+}
+
+void StubbornSetsAtomCentric::compute_stubborn_set(const State &state) {
+    if (!use_cache) {
+        compute_uncached_stubborn_set(state);
+        applicable_stubborn_operators.clear();
+        return;
+    }
+
+    int node;
+    int depth;
+    if (lookup_cached_stubborn_set(state, node, depth)) {
+        ++num_cache_hits;
+    } else {
+        ++num_cache_misses;
+        compute_uncached_stubborn_set(state);
+        if (static_cast<int>(cached_stubborn_operators.size()) < max_cache_size) {
+            insert_into_cache(state, node, depth);
+        }
+        for (int var : read_variables) {
+            variable_is_read[var] = false;
+        }
+        read_variables.clear();
+        applicable_stubborn_operators.clear();
+    }
+
+    /*
+      Recording the variable reads and inserting the results makes cache
+      misses more expensive than computing the stubborn set without the
+      cache. If most states need their own stubborn set, we stop caching.
+    */
+    if (num_cache_hits + num_cache_misses == NUM_LOOKUPS_BEFORE_CHECKING_CACHE &&
+        num_cache_hits < num_cache_misses) {
+        if (log.is_at_least_normal()) {
+            log << "Stubborn set cache hit ratio after "
+                << NUM_LOOKUPS_BEFORE_CHECKING_CACHE << " lookups is below 0.5"
+                << " -> switching off the cache" << endl;
+        }
+        use_cache = false;
+        utils::release_vector_memory(cache_nodes);
+        cache_edges = utils::HashMap<pair<int, int>, int>();
+        utils::release_vector_memory(cached_stubborn_operators);
+    }
+}
+
+void StubbornSetsAtomCentric::print_statistics() const {
+    StubbornSets::print_statistics();
+    if (max_cache_size > 0 && log.is_at_least_normal()) {
+        log << "Stubborn set cache hits: " << num_cache_hits << endl
+            << "Stubborn set cache misses: " << num_cache_misses << endl
+            << "Cached stubborn sets: " << cached_stubborn_operators.size()
+            << endl;
+    }
+}
+
 class StubbornSetsAtomCentricFeature : public plugins::TypedFeature<PruningMethod, StubbornSetsAtomCentric> {
 public:
     StubbornSetsAtomCentricFeature() : TypedFeature("atom_centric_stubborn_sets") {
@@ -273,6 +406,14 @@ public:
             "the goal atoms. All strategies use the fast_downward strategy for "
             "breaking ties.",
             "quick_skip");
+        add_option<int>(
+            "max_cache_size",
+            "maximum number of cached stubborn sets (set to 0 to disable the "
+            "cache). Stubborn sets are cached for the values of the variables "
+            "that their computation reads, so states that agree on these "
+            "variables share the stubborn set.",
+            "100000",
+            plugins::Bounds("0", "infinity"));
         add_pruning_options_to_feature(*this);
     }
 };
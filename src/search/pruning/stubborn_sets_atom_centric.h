@@ -3,6 +3,10 @@
 
 #include "stubborn_sets.h"
 
+#include "../utils/hash.h"
+
+#include <utility>
+
 namespace stubborn_sets_atom_centric {
 static const int MARKED_VALUES_NONE = -2;
 static const int MARKED_VALUES_ALL = -1;
@@ -39,20 +43,58 @@ class StubbornSetsAtomCentric : public stubborn_sets::StubbornSets {
     std::vector<FactPair> producer_queue;
     std::vector<FactPair> consumer_queue;
 
+    /*
+      Memo cache for stubborn sets. The computation of a stubborn set only
+      depends on the state through the variables it reads, and since it
+      is deterministic, the next variable it reads only depends on the
+      values of the variables read before. We therefore store the cached
+      results in a decision tree: each inner node holds the next variable
+      read by the computation and has one child per value, each leaf holds
+      the applicable operators of the resulting stubborn set. (All
+      preconditions of applicable stubborn operators are read.)
+      The tree grows by one path per cache miss until it holds
+      max_cache_size stubborn sets. Lookups that fail return the last
+      node on the path and its depth.
+    */
+    struct CacheNode {
+        // Variable read at this node or -1 for leaves.
+        int var;
+        // Index into cached_stubborn_operators for leaves.
+        int result;
+    };
+    const int max_cache_size;
+    bool use_cache;
+    std::vector<CacheNode> cache_nodes;
+    utils::HashMap<std::pair<int, int>, int> cache_edges;
+    std::vector<std::vector<int>> cached_stubborn_operators;
+    int64_t num_cache_hits;
+    int64_t num_cache_misses;
+    // Variables read while computing the current stubborn set.
+    std::vector<int> read_variables;
+    std::vector<bool> variable_is_read;
+    std::vector<int> applicable_stubborn_operators;
+
     void compute_consumers(const TaskProxy &task_proxy);
-    bool operator_is_applicable(int op, const State &state) const;
+    int get_value(const State &state, int var);
+    FactPair find_unsatisfied_condition(
+        const std::vector<FactPair> &conditions, const State &state);
+    bool operator_is_applicable(int op, const State &state);
     void enqueue_producers(const FactPair &fact);
     void enqueue_consumers(const FactPair &fact);
     void enqueue_sibling_consumers(const FactPair &fact);
     void enqueue_sibling_producers(const FactPair &fact);
-    FactPair select_fact(const std::vector<FactPair> &facts, const State &state) const;
+    FactPair select_fact(const std::vector<FactPair> &facts, const State &state);
     void enqueue_nes(int op, const State &state);
     void enqueue_interferers(int op);
     void handle_stubborn_operator(const State &state, int op);
+    void compute_uncached_stubborn_set(const State &state);
+    bool lookup_cached_stubborn_set(const State &state, int &node, int &depth);
+    void insert_into_cache(const State &state, int node, int depth);
     virtual void compute_stubborn_set(const State &state) override;
 public:
     explicit StubbornSetsAtomCentric(const plugins::Options &opts);
     virtual void initialize(const std::shared_ptr<AbstractTask> &task) override;
+    virtual void print_statistics() const override;
 };
 }
 
@@ -4,58 +4,150 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 
+#include <bit>
+#include <limits>
+
 using namespace std;
 
 namespace stubborn_sets_simple {
+static const int BITS_PER_BLOCK = numeric_limits<uint64_t>::digits;
+
 StubbornSetsSimple::StubbornSetsSimple(const plugins::Options &opts)
-    : StubbornSetsActionCentric(opts) {
+    : StubbornSets(opts),
+      max_interference_cache_mb(opts.get<int>("max_interference_cache_mb")),
+      max_cached_rows(0),
+      lru_head(-1),
+      lru_tail(-1),
+      num_computed_rows(0),
+      stubborn_set(0),
+      handled_operators(0) {
 }
 
 void StubbornSetsSimple::initialize(const shared_ptr<AbstractTask> &task) {
     StubbornSets::initialize(task);
-    interference_relation.resize(num_operators);
-    interference_relation_computed.resize(num_operators, false);
+    TaskProxy task_proxy(*task);
+    compute_operators_with_precondition(task_proxy);
+
+    stubborn_set = Bitset(num_operators);
+    handled_operators = Bitset(num_operators);
+    int64_t bytes_per_row = stubborn_set.get_num_blocks() * sizeof(uint64_t);
+    int64_t max_rows = max<int64_t>(
+        1, static_cast<int64_t>(max_interference_cache_mb) * 1024 * 1024 /
+        max<int64_t>(bytes_per_row, 1));
+    max_cached_rows = static_cast<int>(min<int64_t>(max_rows, num_operators));
+    slot_of_operator.assign(num_operators, -1);
+
     log << "pruning method: stubborn sets simple" << endl;
+    if (log.is_at_least_normal()) {
+        log << "Caching at most " << max_cached_rows << " of "
+            << num_operators << " rows of the interference relation." << endl;
+    }
 }
 
-const vector<int> &StubbornSetsSimple::get_interfering_operators(int op1_no) {
-    /*
-       TODO: as interference is symmetric, we only need to compute the
-       relation for operators (o1, o2) with (o1 < o2) and add a lookup
-       method that looks up (i, j) if i < j and (j, i) otherwise.
-    */
-    vector<int> &interfere_op1 = interference_relation[op1_no];
-    if (!interference_relation_computed[op1_no]) {
-        for (int op2_no = 0; op2_no < num_operators; ++op2_no) {
-            if (op1_no != op2_no && interfere(op1_no, op2_no)) {
-                interfere_op1.push_back(op2_no);
+void StubbornSetsSimple::compute_operators_with_precondition(
+    const TaskProxy &task_proxy) {
+    operators_with_precondition = utils::map_vector<vector<vector<int>>>(
+        task_proxy.get_variables(), [](const VariableProxy &var) {
+            return vector<vector<int>>(var.get_domain_size());
+        });
+    for (int op_no = 0; op_no < num_operators; ++op_no) {
+        for (const FactPair &pre : sorted_op_preconditions[op_no]) {
+            operators_with_precondition[pre.var][pre.value].push_back(op_no);
+        }
+    }
+}
+
+/*
+  Operators op1 and op2 interfere iff op1 can disable op2, op2 can disable
+  op1, or their effects conflict. Instead of testing all pairs, we collect
+  the operators that mention a variable of op1 with a different value.
+*/
+void StubbornSetsSimple::compute_interference_row(int op1_no, Bitset &row) const {
+    for (const FactPair &eff : sorted_op_effects[op1_no]) {
+        int num_values = achievers[eff.var].size();
+        for (int value = 0; value < num_values; ++value) {
+            if (value != eff.value) {
+                for (int op2_no : operators_with_precondition[eff.var][value]) {
+                    row.set(op2_no);
+                }
+                for (int op2_no : achievers[eff.var][value]) {
+                    row.set(op2_no);
+                }
+            }
+        }
+    }
+    for (const FactPair &pre : sorted_op_preconditions[op1_no]) {
+        int num_values = achievers[pre.var].size();
+        for (int value = 0; value < num_values; ++value) {
+            if (value != pre.value) {
+                for (int op2_no : achievers[pre.var][value]) {
+                    row.set(op2_no);
+                }
             }
         }
-        interfere_op1.shrink_to_fit();
-        interference_relation_computed[op1_no] = true;
     }
-    return interfere_op1;
+    row.reset(op1_no);
 }
 
-// Add all operators that achieve the fact (var, value) to stubborn set.
-void StubbornSetsSimple::add_necessary_enabling_set(const FactPair &fact) {
-    for (int op_no : achievers[fact.var][fact.value]) {
-        enqueue_stubborn_operator(op_no);
+void StubbornSetsSimple::unlink_slot(int slot) {
+    int previous = previous_slot[slot];
+    int next = next_slot[slot];
+    if (previous == -1) {
+        lru_head = next;
+    } else {
+        next_slot[previous] = next;
+    }
+    if (next == -1) {
+        lru_tail = previous;
+    } else {
+        previous_slot[next] = previous;
     }
 }
 
-// Add all operators that interfere with op.
-void StubbornSetsSimple::add_interfering(int op_no) {
-    for (int interferer_no : get_interfering_operators(op_no)) {
-        enqueue_stubborn_operator(interferer_no);
+void StubbornSetsSimple::push_slot_to_front(int slot) {
+    previous_slot[slot] = -1;
+    next_slot[slot] = lru_head;
+    if (lru_head == -1) {
+        lru_tail = slot;
+    } else {
+        previous_slot[lru_head] = slot;
     }
+    lru_head = slot;
 }
 
-void StubbornSetsSimple::initialize_stubborn_set(const State &state) {
-    // Add a necessary enabling set for an unsatisfied goal.
-    FactPair unsatisfied_goal = find_unsatisfied_goal(state);
-    assert(unsatisfied_goal != FactPair::no_fact);
-    add_necessary_enabling_set(unsatisfied_goal);
+const StubbornSetsSimple::Bitset &StubbornSetsSimple::get_interfering_operators(
+    int op1_no) {
+    int slot = slot_of_operator[op1_no];
+    if (slot == -1) {
+        if (static_cast<int>(cached_rows.size()) < max_cached_rows) {
+            slot = cached_rows.size();
+            cached_rows.emplace_back(num_operators);
+            operator_of_slot.push_back(-1);
+            previous_slot.push_back(-1);
+            next_slot.push_back(-1);
+        } else {
+            // Evict the least recently used row.
+            slot = lru_tail;
+            unlink_slot(slot);
+            slot_of_operator[operator_of_slot[slot]] = -1;
+            cached_rows[slot].reset();
+        }
+        compute_interference_row(op1_no, cached_rows[slot]);
+        ++num_computed_rows;
+        operator_of_slot[slot] = op1_no;
+        slot_of_operator[op1_no] = slot;
+    } else {
+        unlink_slot(slot);
+    }
+    push_slot_to_front(slot);
+    return cached_rows[slot];
+}
+
+// Add all operators that achieve the fact (var, value) to stubborn set.
+void StubbornSetsSimple::add_necessary_enabling_set(const FactPair &fact) {
+    for (int op_no : achievers[fact.var][fact.value]) {
+        stubborn_set.set(op_no);
+    }
 }
 
 void StubbornSetsSimple::handle_stubborn_operator(const State &state,
@@ -65,7 +157,7 @@ void StubbornSetsSimple::handle_stubborn_operator(const State &state,
         /* no unsatisfied precondition found
            => operator is applicable
            => add all interfering operators */
-        add_interfering(op_no);
+        stubborn_set |= get_interfering_operators(op_no);
     } else {
         /* unsatisfied precondition found
            => add a necessary enabling set for it */
@@ -73,6 +165,54 @@ void StubbornSetsSimple::handle_stubborn_operator(const State &state,
     }
 }
 
+void StubbornSetsSimple::compute_stubborn_set(const State &state) {
+    stubborn_set.reset();
+    handled_operators.reset();
+
+    // Add a necessary enabling set for an unsatisfied goal.
+    FactPair unsatisfied_goal =
+        stubborn_sets::find_unsatisfied_condition(sorted_goals, state);
+    assert(unsatisfied_goal != FactPair::no_fact);
+    add_necessary_enabling_set(unsatisfied_goal);
+
+    /*
+      Handle the operators in the stubborn set until a fixpoint is reached.
+      We find unhandled operators block by block. Handling an operator can
+      add operators to blocks that we already passed, so we repeat the
+      sweep until it handles no more operators.
+    */
+    int num_blocks = stubborn_set.get_num_blocks();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < num_blocks; ++i) {
+            uint64_t unhandled;
+            while ((unhandled = stubborn_set.get_block(i) &
+                                ~handled_operators.get_block(i)) != 0) {
+                int op_no = i * BITS_PER_BLOCK + countr_zero(unhandled);
+                handled_operators.set(op_no);
+                handle_stubborn_operator(state, op_no);
+                changed = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_blocks; ++i) {
+        for (uint64_t block = stubborn_set.get_block(i); block != 0;
+             block &= block - 1) {
+            stubborn[i * BITS_PER_BLOCK + countr_zero(block)] = true;
+        }
+    }
+}
+
+void StubbornSetsSimple::print_statistics() const {
+    StubbornSets::print_statistics();
+    if (log.is_at_least_normal()) {
+        log << "Computed rows of the interference relation: "
+            << num_computed_rows << endl;
+    }
+}
+
 class StubbornSetsSimpleFeature : public plugins::TypedFeature<PruningMethod, StubbornSetsSimple> {
 public:
     StubbornSetsSimpleFeature() : TypedFeature("stubborn_sets_simple") {
@@ -102,6 +242,13 @@ public:
                 "323-331",
                 "AAAI Press",
                 "2014"));
+        add_option<int>(
+            "max_interference_cache_mb",
+            "maximum memory in MiB for caching rows of the interference "
+            "relation. Rows are computed on demand and the least recently "
+            "used rows are evicted if the limit is reached.",
+            "256",
+            plugins::Bounds("1", "infinity"));
         add_pruning_options_to_feature(*this);
     }
 };
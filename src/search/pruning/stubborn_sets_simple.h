@@ -1,33 +1,62 @@
 #ifndef PRUNING_STUBBORN_SETS_SIMPLE_H
 #define PRUNING_STUBBORN_SETS_SIMPLE_H
 
-#include "stubborn_sets_action_centric.h"
+#include "stubborn_sets.h"
+
+#include "../algorithms/dynamic_bitset.h"
+
+#include <cstdint>
 
 namespace stubborn_sets_simple {
 /* Implementation of simple instantiation of strong stubborn sets.
-   Disjunctive action landmarks are computed trivially.*/
-class StubbornSetsSimple : public stubborn_sets::StubbornSetsActionCentric {
-    /* interference_relation[op1_no] contains all operator indices
-       of operators that interfere with op1. */
-    std::vector<std::vector<int>> interference_relation;
-    std::vector<bool> interference_relation_computed;
+   Disjunctive action landmarks are computed trivially.
+
+   Operator sets are represented as bitsets, so that adding all operators
+   that interfere with an operator is a word-wise union. */
+class StubbornSetsSimple : public stubborn_sets::StubbornSets {
+    using Bitset = dynamic_bitset::DynamicBitset<uint64_t>;
+
+    /* operators_with_precondition[var][value] contains all operator
+       indices of operators with precondition (var, value). */
+    std::vector<std::vector<std::vector<int>>> operators_with_precondition;
+
+    /*
+      Rows of the interference relation: the row of op1 contains all
+      operators that interfere with op1. Rows are computed on demand and
+      cached in at most max_cached_rows slots. If all slots are in use, we
+      evict the least recently used row. The slots form a doubly linked
+      list from the most recently used (lru_head) to the least recently
+      used (lru_tail) slot.
+    */
+    const int max_interference_cache_mb;
+    int max_cached_rows;
+    std::vector<Bitset> cached_rows;
+    std::vector<int> slot_of_operator;
+    std::vector<int> operator_of_slot;
+    std::vector<int> previous_slot;
+    std::vector<int> next_slot;
+    int lru_head;
+    int lru_tail;
+    int64_t num_computed_rows;
+
+    // Operators in the stubborn set and those that have been handled.
+    Bitset stubborn_set;
+    Bitset handled_operators;
+
+    void compute_operators_with_precondition(const TaskProxy &task_proxy);
+    void compute_interference_row(int op1_no, Bitset &row) const;
+    void unlink_slot(int slot);
+    void push_slot_to_front(int slot);
+    const Bitset &get_interfering_operators(int op1_no);
 
     void add_necessary_enabling_set(const FactPair &fact);
-    void add_interfering(int op_no);
-
-    inline bool interfere(int op1_no, int op2_no) {
-        return can_disable(op1_no, op2_no) ||
-               can_conflict(op1_no, op2_no) ||
-               can_disable(op2_no, op1_no);
-    }
-    const std::vector<int> &get_interfering_operators(int op1_no);
+    void handle_stubborn_operator(const State &state, int op_no);
 protected:
-    virtual void initialize_stubborn_set(const State &state) override;
-    virtual void handle_stubborn_operator(const State &state,
-                                          int op_no) override;
+    virtual void compute_stubborn_set(const State &state) override;
 public:
     explicit StubbornSetsSimple(const plugins::Options &opts);
     virtual void initialize(const std::shared_ptr<AbstractTask> &task) override;
+    virtual void print_statistics() const override;
 };
 }
 
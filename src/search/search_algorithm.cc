@@ -47,13 +47,15 @@ SearchAlgorithm::SearchAlgorithm(const plugins::Options &opts)
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_from_options(opts)),
-      state_registry(task_proxy),
+      state_storage(opts.get<shared_ptr<StateStorage>>("state_storage")),
+      state_registry(task_proxy, state_storage->get_memory_resource()),
       successor_generator(get_successor_generator(task_proxy, log)),
       search_space(state_registry, log),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
-      max_time(opts.get<double>("max_time")) {
+      max_time(opts.get<double>("max_time")),
+      stop_requested(false) {
     if (opts.get<int>("bound") < 0) {
         cerr << "error: negative cost bound " << opts.get<int>("bound") << endl;
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
@@ -93,9 +95,15 @@ void SearchAlgorithm::search() {
             status = TIMEOUT;
             break;
         }
+        if (stop_requested && status == IN_PROGRESS) {
+            log << "Stop requested. Abort search." << endl;
+            status = TIMEOUT;
+            break;
+        }
     }
     // TODO: Revise when and which search times are logged.
     log << "Actual search time: " << timer.get_elapsed_time() << endl;
+    state_storage->print_statistics(log);
 }
 
 bool SearchAlgorithm::check_goal_and_set_plan(const State &state) {
@@ -148,6 +156,11 @@ void SearchAlgorithm::add_options_to_feature(plugins::Feature &feature) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    feature.add_option<shared_ptr<StateStorage>>(
+        "state_storage",
+        "where to store the states of the search and the information "
+        "associated with them",
+        "ram()");
     utils::add_log_options_to_feature(feature);
 }
 
@@ -8,10 +8,12 @@
 #include "search_space.h"
 #include "search_statistics.h"
 #include "state_registry.h"
+#include "state_storage.h"
 #include "task_proxy.h"
 
 #include "utils/logging.h"
 
+#include <atomic>
 #include <vector>
 
 namespace plugins {
@@ -43,15 +45,19 @@ protected:
 
     mutable utils::LogProxy log;
     PlanManager plan_manager;
+    // The state storage must outlive the state registry.
+    std::shared_ptr<StateStorage> state_storage;
     StateRegistry state_registry;
     const successor_generator::SuccessorGenerator &successor_generator;
     SearchSpace search_space;
     SearchProgress search_progress;
     SearchStatistics statistics;
-    int bound;
+    // The bound can be lowered by other threads during the search.
+    std::atomic<int> bound;
     OperatorCost cost_type;
     bool is_unit_cost;
     double max_time;
+    std::atomic<bool> stop_requested;
 
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
@@ -71,6 +77,11 @@ public:
     const SearchStatistics &get_statistics() const {return statistics;}
     void set_bound(int b) {bound = b;}
     int get_bound() {return bound;}
+    /*
+      Ask the search to stop after the current step. This can be called from
+      other threads. The search then ends with status TIMEOUT.
+    */
+    void request_stop() {stop_requested = true;}
     PlanManager &get_plan_manager() {return plan_manager;}
     std::string get_description() {return description;}
 
@@ -0,0 +1,507 @@
+#include "external_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <set>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace external_search {
+// Number of states that we read from a run at once.
+static const int64_t READ_CHUNK_SIZE = 4096;
+
+static void exit_with_file_error(const string &filename) {
+    cerr << "Failed to access file of external search: " << filename << endl;
+    utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+static int compare_states(
+    const PackedStateBin *lhs, const PackedStateBin *rhs, int num_bins) {
+    return memcmp(lhs, rhs, num_bins * sizeof(PackedStateBin));
+}
+
+class RunReader {
+    const string filename;
+    const int num_bins;
+    ifstream stream;
+    int64_t num_unread_states;
+    vector<PackedStateBin> buffer;
+    size_t num_buffered_states;
+    size_t pos;
+
+    void fill_buffer() {
+        int64_t num_states = min(num_unread_states, READ_CHUNK_SIZE);
+        buffer.resize(num_states * num_bins);
+        stream.read(reinterpret_cast<char *>(buffer.data()),
+                    buffer.size() * sizeof(PackedStateBin));
+        if (!stream) {
+            exit_with_file_error(filename);
+        }
+        num_unread_states -= num_states;
+        num_buffered_states = num_states;
+        pos = 0;
+    }
+public:
+    RunReader(const SortedRun &run, int num_bins)
+        : filename(run.filename),
+          num_bins(num_bins),
+          stream(run.filename, ios::binary),
+          num_unread_states(run.num_states),
+          num_buffered_states(0),
+          pos(0) {
+        if (!stream) {
+            exit_with_file_error(filename);
+        }
+        fill_buffer();
+    }
+
+    bool is_done() const {
+        return pos == num_buffered_states;
+    }
+
+    const PackedStateBin *get_state() const {
+        assert(!is_done());
+        return &buffer[pos * num_bins];
+    }
+
+    void advance() {
+        assert(!is_done());
+        ++pos;
+        if (pos == num_buffered_states && num_unread_states > 0) {
+            fill_buffer();
+        }
+    }
+};
+
+/*
+  Reads the union of several sorted runs in sorted order. States contained
+  in several runs are returned several times.
+*/
+class RunMerger {
+    const int num_bins;
+    vector<unique_ptr<RunReader>> readers;
+    // Min-heap of the readers that are not done.
+    vector<int> heap;
+
+    bool has_larger_state(int reader1, int reader2) const {
+        return compare_states(readers[reader1]->get_state(),
+                              readers[reader2]->get_state(), num_bins) > 0;
+    }
+
+    auto get_heap_order() const {
+        return [this](int reader1, int reader2) {
+                   return has_larger_state(reader1, reader2);
+               };
+    }
+public:
+    RunMerger(const vector<SortedRun> &runs, int num_bins)
+        : num_bins(num_bins) {
+        for (const SortedRun &run : runs) {
+            readers.push_back(utils::make_unique_ptr<RunReader>(run, num_bins));
+            if (!readers.back()->is_done()) {
+                heap.push_back(readers.size() - 1);
+            }
+        }
+        make_heap(heap.begin(), heap.end(), get_heap_order());
+    }
+
+    bool is_done() const {
+        return heap.empty();
+    }
+
+    const PackedStateBin *get_state() const {
+        return readers[heap.front()]->get_state();
+    }
+
+    void advance() {
+        pop_heap(heap.begin(), heap.end(), get_heap_order());
+        RunReader &reader = *readers[heap.back()];
+        reader.advance();
+        if (reader.is_done()) {
+            heap.pop_back();
+        } else {
+            push_heap(heap.begin(), heap.end(), get_heap_order());
+        }
+    }
+};
+
+class RunWriter {
+    const int num_bins;
+    ofstream stream;
+    SortedRun &run;
+public:
+    RunWriter(SortedRun &run, int num_bins)
+        : num_bins(num_bins),
+          stream(run.filename, ios::binary | ios::trunc),
+          run(run) {
+        if (!stream) {
+            exit_with_file_error(run.filename);
+        }
+        run.num_states = 0;
+    }
+
+    void write(const PackedStateBin *data) {
+        stream.write(reinterpret_cast<const char *>(data),
+                     num_bins * sizeof(PackedStateBin));
+        ++run.num_states;
+    }
+
+    int64_t close() {
+        stream.close();
+        if (!stream) {
+            exit_with_file_error(run.filename);
+        }
+        return run.num_states * num_bins * sizeof(PackedStateBin);
+    }
+};
+
+
+ExternalSearch::ExternalSearch(const plugins::Options &opts)
+    : SearchAlgorithm(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      directory(opts.get<string>("directory")),
+      num_bins(state_registry.get_state_packer().get_num_bins()),
+      num_buffered_bins(0),
+      next_file_id(0),
+      num_runs(0),
+      num_bytes_written(0),
+      num_evaluation_registries(0) {
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "External search does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+    }
+    /*
+      We use half of the memory budget for buffering generated states and
+      the other half for the temporary state registry. For the latter, we
+      estimate the overhead of the hash set and the heuristic cache with 32
+      bytes per state.
+    */
+    size_t budget = static_cast<size_t>(opts.get<int>("memory_budget")) * 1024 * 1024 / 2;
+    max_buffered_bins = budget / sizeof(PackedStateBin);
+    max_evaluation_registry_size =
+        budget / (num_bins * sizeof(PackedStateBin) + 32);
+}
+
+ExternalSearch::~ExternalSearch() {
+    for (const auto &entry : open_buckets) {
+        for (const SortedRun &run : entry.second.runs) {
+            remove_run(run);
+        }
+    }
+    for (const Layer &layer : layers) {
+        remove_run(layer.run);
+    }
+}
+
+string ExternalSearch::create_filename() {
+    return directory + "/downward-external-" +
+           to_string(utils::get_process_id()) + "-" +
+           to_string(next_file_id++);
+}
+
+SortedRun ExternalSearch::write_sorted_run(vector<PackedStateBin> &buffer) {
+    assert(buffer.size() % num_bins == 0);
+    vector<int> order(buffer.size() / num_bins);
+    iota(order.begin(), order.end(), 0);
+    auto get_data = [&](int index) {
+            return &buffer[static_cast<size_t>(index) * num_bins];
+        };
+    sort(order.begin(), order.end(), [&](int index1, int index2) {
+             return compare_states(get_data(index1), get_data(index2), num_bins) < 0;
+         });
+
+    SortedRun run {create_filename(), 0};
+    RunWriter writer(run, num_bins);
+    const PackedStateBin *last_data = nullptr;
+    for (int index : order) {
+        const PackedStateBin *data = get_data(index);
+        if (!last_data || compare_states(last_data, data, num_bins) != 0) {
+            writer.write(data);
+            last_data = data;
+        }
+    }
+    num_bytes_written += writer.close();
+    ++num_runs;
+    utils::release_vector_memory(buffer);
+    return run;
+}
+
+void ExternalSearch::flush_buffers() {
+    for (auto &entry : open_buckets) {
+        Bucket &bucket = entry.second;
+        if (!bucket.buffer.empty()) {
+            bucket.runs.push_back(write_sorted_run(bucket.buffer));
+        }
+    }
+    num_buffered_bins = 0;
+}
+
+void ExternalSearch::remove_run(const SortedRun &run) {
+    remove(run.filename.c_str());
+}
+
+StateRegistry &ExternalSearch::get_evaluation_registry() {
+    if (!evaluation_registry ||
+        evaluation_registry->size() >= max_evaluation_registry_size) {
+        // Free the memory of the old registry before creating the new one.
+        evaluation_registry = nullptr;
+        evaluation_registry = utils::make_unique_ptr<StateRegistry>(task_proxy);
+        ++num_evaluation_registries;
+    }
+    return *evaluation_registry;
+}
+
+void ExternalSearch::add_to_bucket(const PackedStateBin *data, int g, int h) {
+    vector<PackedStateBin> &buffer = open_buckets[make_pair(g + h, g)].buffer;
+    buffer.insert(buffer.end(), data, data + num_bins);
+    num_buffered_bins += num_bins;
+    if (num_buffered_bins >= max_buffered_bins) {
+        flush_buffers();
+    }
+}
+
+void ExternalSearch::insert(const State &state, int g) {
+    EvaluationContext eval_context(state, g, false, &statistics);
+    statistics.inc_evaluated_states();
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        statistics.inc_dead_ends();
+        return;
+    }
+    if (search_progress.check_progress(eval_context)) {
+        statistics.print_checkpoint_line(g);
+    }
+    int h = eval_context.get_evaluator_value(evaluator.get());
+    add_to_bucket(state.get_buffer(), g, h);
+}
+
+void ExternalSearch::initialize() {
+    log << "Conducting external A* search, (real) bound = " << bound << endl;
+    const State &initial_state = state_registry.get_initial_state();
+    const PackedStateBin *data = initial_state.get_buffer();
+    initial_state_data.assign(data, data + num_bins);
+
+    EvaluationContext eval_context(initial_state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        log << "Initial state is a dead end." << endl;
+    } else {
+        if (search_progress.check_progress(eval_context))
+            statistics.print_checkpoint_line(0);
+        int h = eval_context.get_evaluator_value(evaluator.get());
+        statistics.report_f_value_progress(h);
+        add_to_bucket(data, 0, h);
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+SearchStatus ExternalSearch::step() {
+    if (open_buckets.empty()) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    auto bucket_it = open_buckets.begin();
+    auto [f, g] = bucket_it->first;
+    int h = f - g;
+    Bucket bucket = move(bucket_it->second);
+    open_buckets.erase(bucket_it);
+    num_buffered_bins -= bucket.buffer.size();
+    if (!bucket.buffer.empty()) {
+        bucket.runs.push_back(write_sorted_run(bucket.buffer));
+    }
+    statistics.report_f_value_progress(f);
+
+    /*
+      States generated while expanding the bucket go to new buckets. This
+      includes states with the same f and g value (reached with operators
+      of cost 0), which we expand in the next step.
+    */
+    vector<SortedRun> closed_runs;
+    for (int layer_id : layers_by_h[h]) {
+        if (layers[layer_id].g <= g) {
+            closed_runs.push_back(layers[layer_id].run);
+        }
+    }
+    RunMerger open_states(bucket.runs, num_bins);
+    RunMerger closed_states(closed_runs, num_bins);
+
+    int num_layer = layers.size();
+    Layer layer {g, {create_filename(), 0}};
+    RunWriter writer(layer.run, num_bins);
+    vector<PackedStateBin> data;
+    bool solved = false;
+    while (!open_states.is_done()) {
+        const PackedStateBin *next_data = open_states.get_state();
+        if (!data.empty() && compare_states(data.data(), next_data, num_bins) == 0) {
+            open_states.advance();
+            continue;
+        }
+        data.assign(next_data, next_data + num_bins);
+        open_states.advance();
+        while (!closed_states.is_done() &&
+               compare_states(closed_states.get_state(), data.data(), num_bins) < 0) {
+            closed_states.advance();
+        }
+        if (!closed_states.is_done() &&
+            compare_states(closed_states.get_state(), data.data(), num_bins) == 0) {
+            continue;
+        }
+        writer.write(data.data());
+        if (expand(data.data(), g, num_layer)) {
+            solved = true;
+            break;
+        }
+    }
+    num_bytes_written += writer.close();
+    for (const SortedRun &run : bucket.runs) {
+        remove_run(run);
+    }
+    if (layer.run.num_states == 0) {
+        remove_run(layer.run);
+    } else {
+        layers_by_h[h].push_back(num_layer);
+        layers.push_back(move(layer));
+    }
+    return solved ? SOLVED : IN_PROGRESS;
+}
+
+bool ExternalSearch::expand(const PackedStateBin *data, int g, int num_layer) {
+    StateRegistry &registry = get_evaluation_registry();
+    State state = registry.insert_packed_state(data);
+    statistics.inc_expanded();
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        log << "Solution found!" << endl;
+        trace_path(data, g, num_layer);
+        return true;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_g = g + get_adjusted_cost(op);
+        if (succ_g >= bound)
+            continue;
+        State succ_state = registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        insert(succ_state, succ_g);
+    }
+    return false;
+}
+
+void ExternalSearch::trace_path(
+    const PackedStateBin *goal_data, int g, int num_layer) {
+    /*
+      The state was generated by expanding a state of an earlier layer
+      whose g value plus the operator cost is the g value of the state.
+      We search the layers backwards for such a predecessor.
+    */
+    vector<PackedStateBin> current_data(goal_data, goal_data + num_bins);
+    Plan plan;
+    while (current_data != initial_state_data) {
+        bool found = false;
+        for (int layer_id = num_layer - 1; layer_id >= 0 && !found; --layer_id) {
+            const Layer &layer = layers[layer_id];
+            if (layer.g > g)
+                continue;
+            for (RunReader reader(layer.run, num_bins);
+                 !reader.is_done() && !found; reader.advance()) {
+                StateRegistry &registry = get_evaluation_registry();
+                State state = registry.insert_packed_state(reader.get_state());
+                vector<OperatorID> applicable_ops;
+                successor_generator.generate_applicable_ops(state, applicable_ops);
+                for (OperatorID op_id : applicable_ops) {
+                    OperatorProxy op = task_proxy.get_operators()[op_id];
+                    if (layer.g + get_adjusted_cost(op) != g)
+                        continue;
+                    State succ_state = registry.get_successor_state(state, op);
+                    if (equal(current_data.begin(), current_data.end(),
+                              succ_state.get_buffer())) {
+                        plan.push_back(op_id);
+                        current_data.assign(
+                            reader.get_state(), reader.get_state() + num_bins);
+                        g = layer.g;
+                        num_layer = layer_id;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!found) {
+            ABORT("No predecessor found while tracing the solution path.");
+        }
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void ExternalSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Expanded layers: " << layers.size() << endl;
+    log << "Sorted runs: " << num_runs << endl;
+    log << "Bytes written to disk: " << num_bytes_written << endl;
+    log << "Evaluation registries: " << num_evaluation_registries << endl;
+}
+
+class ExternalSearchFeature : public plugins::TypedFeature<SearchAlgorithm, ExternalSearch> {
+public:
+    ExternalSearchFeature() : TypedFeature("external_astar") {
+        document_title("External A* search");
+        document_synopsis(
+            "A* search with delayed duplicate detection that stores the "
+            "open and closed states in sorted files on disk instead of "
+            "keeping them in memory. States are expanded in buckets of "
+            "states with the same g and h values, ordered by f and then by g. "
+            "Closed states are never reopened, but a state that is reached "
+            "with a lower g value than before (which is only possible with "
+            "an inconsistent heuristic) is expanded again.");
+
+        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<string>(
+            "directory",
+            "directory for the files that store the open and closed states",
+            "\".\"");
+        add_option<int>(
+            "memory_budget",
+            "memory in MiB for buffering generated states before they are "
+            "written to disk and for evaluating states",
+            "1024",
+            plugins::Bounds("1", "infinity"));
+        SearchAlgorithm::add_options_to_feature(*this);
+
+        document_note(
+            "Breadth-first search",
+            "\n```\n--search external_astar(const(0), cost_type=one)\n```\n"
+            "is a breadth-first search with delayed duplicate detection.",
+            true);
+        document_note(
+            "Bound",
+            "The bound is compared to the g values with the adjusted "
+            "operator costs (see cost_type).");
+        document_note(
+            "Path-dependent evaluators",
+            "The evaluator must not be path-dependent.");
+    }
+};
+
+static plugins::FeaturePlugin<ExternalSearchFeature> _plugin;
+}
@@ -0,0 +1,101 @@
+#ifndef SEARCH_ALGORITHMS_EXTERNAL_SEARCH_H
+#define SEARCH_ALGORITHMS_EXTERNAL_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Evaluator;
+
+namespace plugins {
+class Options;
+}
+
+namespace external_search {
+// A file of packed states in lexicographic order without duplicates.
+struct SortedRun {
+    std::string filename;
+    int64_t num_states;
+};
+
+/*
+  A* search with delayed duplicate detection that keeps the open and closed
+  lists on disk (External A*, Edelkamp, Jabbar and Schroedl, 2004).
+
+  States are stored as their packed data and grouped into buckets of states
+  with the same g and h value. Generated states are collected in memory and
+  written to sorted runs once the buffers are full. To expand a bucket, we
+  merge its runs, remove the duplicates and the states that are contained
+  in previously expanded layers with the same h value and a g value that is
+  not larger. The remaining states are written to a new layer file and
+  expanded. Since h is a function of the state, this finds all duplicates
+  except for states that are reached with a smaller g value later, which
+  can only happen with inconsistent heuristics (like reopening in A*).
+
+  Buckets are expanded by increasing f and then increasing g value. Plans
+  are reconstructed by scanning the layers backwards for predecessors.
+
+  The evaluator is called on states that are registered in a temporary
+  state registry which we replace when it grows too large.
+*/
+class ExternalSearch : public SearchAlgorithm {
+    struct Bucket {
+        std::vector<PackedStateBin> buffer;
+        std::vector<SortedRun> runs;
+    };
+
+    // An expanded (part of a) bucket.
+    struct Layer {
+        int g;
+        SortedRun run;
+    };
+
+    std::shared_ptr<Evaluator> evaluator;
+    const std::string directory;
+    const int num_bins;
+    size_t max_buffered_bins;
+    size_t max_evaluation_registry_size;
+
+    // Maps (f, g) to the bucket of open states with these values.
+    std::map<std::pair<int, int>, Bucket> open_buckets;
+    size_t num_buffered_bins;
+    // Layers in the order in which they were expanded.
+    std::vector<Layer> layers;
+    // Maps h values to the IDs of the layers with this h value.
+    std::map<int, std::vector<int>> layers_by_h;
+    std::vector<PackedStateBin> initial_state_data;
+    std::unique_ptr<StateRegistry> evaluation_registry;
+
+    int next_file_id;
+    int64_t num_runs;
+    int64_t num_bytes_written;
+    int num_evaluation_registries;
+
+    std::string create_filename();
+    SortedRun write_sorted_run(std::vector<PackedStateBin> &buffer);
+    void flush_buffers();
+    void remove_run(const SortedRun &run);
+    StateRegistry &get_evaluation_registry();
+    void add_to_bucket(const PackedStateBin *data, int g, int h);
+    void insert(const State &state, int g);
+    bool expand(const PackedStateBin *data, int g, int num_layer);
+    void trace_path(const PackedStateBin *goal_data, int g, int num_layer);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalSearch(const plugins::Options &opts);
+    virtual ~ExternalSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
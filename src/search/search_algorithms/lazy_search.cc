@@ -3,15 +3,22 @@
 #include "../open_list_factory.h"
 
 #include "../algorithms/ordered_set.h"
+#include "../parser/decorated_abstract_syntax_tree.h"
+#include "../parser/lexical_analyzer.h"
+#include "../parser/syntax_analyzer.h"
+#include "../plugins/any.h"
 #include "../plugins/options.h"
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
+#include "../utils/system.h"
 
 #include <algorithm>
 #include <limits>
+#include <set>
 #include <vector>
 
 using namespace std;
@@ -25,6 +32,11 @@ LazySearch::LazySearch(const plugins::Options &opts)
       randomize_successors(opts.get<bool>("randomize_successors")),
       preferred_successors_first(opts.get<bool>("preferred_successors_first")),
       rng(utils::parse_rng_from_options(opts)),
+      batch_size(1),
+      num_threads(1),
+      repeat_last_restart(false),
+      num_restarts(0),
+      has_stored_preferred_operators(vector<bool>(1, false)),
       current_state(state_registry.get_initial_state()),
       current_predecessor_id(StateID::no_state),
       current_operator_id(OperatorID::no_operator),
@@ -42,6 +54,73 @@ void LazySearch::set_preferred_operator_evaluators(
     preferred_operator_evaluators = evaluators;
 }
 
+void LazySearch::set_batch_options(
+    int batch_size, int num_threads,
+    const vector<shared_ptr<Evaluator>> &parallel_evaluators) {
+    this->batch_size = batch_size;
+    this->num_threads = num_threads;
+    this->parallel_evaluators = parallel_evaluators;
+}
+
+void LazySearch::set_restart_options(
+    const vector<shared_ptr<OpenListFactory>> &open_list_factories,
+    bool repeat_last) {
+    restart_open_list_factories = open_list_factories;
+    repeat_last_restart = repeat_last;
+}
+
+/*
+  Create an independent copy of the evaluator by parsing its configuration
+  again. This only works for evaluators whose configuration does not refer
+  to variables.
+*/
+static shared_ptr<Evaluator> create_evaluator_copy(const Evaluator &evaluator) {
+    try {
+        parser::TokenStream tokens = parser::split_tokens(evaluator.get_description());
+        parser::ASTNodePtr parsed = parser::parse(tokens);
+        parser::DecoratedASTNodePtr decorated = parsed->decorate();
+        return plugins::any_cast<shared_ptr<Evaluator>>(decorated->construct());
+    } catch (const utils::ContextError &e) {
+        cerr << "Failed to copy evaluator " << evaluator.get_description()
+             << " for parallel evaluation:" << endl << e.get_message() << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void LazySearch::create_evaluator_copies() {
+    set<Evaluator *> copied;
+    vector<shared_ptr<Evaluator>> candidates = parallel_evaluators;
+    candidates.insert(candidates.end(), preferred_operator_evaluators.begin(),
+                      preferred_operator_evaluators.end());
+    for (const shared_ptr<Evaluator> &evaluator : candidates) {
+        set<Evaluator *> evals;
+        evaluator->get_path_dependent_evaluators(evals);
+        if (evals.empty() && copied.insert(evaluator.get()).second) {
+            copied_evaluators.push_back(evaluator.get());
+        }
+    }
+    log << "Evaluating batches of " << batch_size << " states in "
+        << num_threads << " threads with copies of " << copied_evaluators.size()
+        << " evaluator(s)." << endl;
+
+    State initial_state = state_registry.get_initial_state();
+    evaluator_copies.resize(num_threads);
+    for (vector<shared_ptr<Evaluator>> &copies : evaluator_copies) {
+        for (Evaluator *evaluator : copied_evaluators) {
+            copies.push_back(create_evaluator_copy(*evaluator));
+        }
+        /*
+          Evaluate the initial state once in the main thread. Like this,
+          the copies set up their data for the state registry and other
+          lazily initialized data before they are used in parallel.
+        */
+        EvaluationContext eval_context(initial_state, 0, true, nullptr);
+        for (const shared_ptr<Evaluator> &copy : copies) {
+            eval_context.get_result(copy.get());
+        }
+    }
+}
+
 void LazySearch::initialize() {
     log << "Conducting lazy best first search, (real) bound = " << bound << endl;
 
@@ -60,6 +139,10 @@ void LazySearch::initialize() {
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
     }
+
+    if (num_threads > 1) {
+        create_evaluator_copies();
+    }
 }
 
 vector<OperatorID> LazySearch::get_successor_operators(
@@ -86,13 +169,47 @@ vector<OperatorID> LazySearch::get_successor_operators(
     }
 }
 
+void LazySearch::collect_current_preferred_operators(
+    ordered_set::OrderedSet<OperatorID> &preferred_operators) {
+    if (restart_open_list_factories.empty()) {
+        for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
+            collect_preferred_operators(current_eval_context,
+                                        preferred_operator_evaluator.get(),
+                                        preferred_operators);
+        }
+        return;
+    }
+
+    /*
+      After a restart, the evaluators return cached values without preferred
+      operators for states that were evaluated before. Since all evaluated
+      states are expanded (unless they are dead ends or goal states), we can
+      use the preferred operators stored in the earlier expansion instead.
+    */
+    if (preferred_operator_evaluators.empty()) {
+        return;
+    }
+    BitsetView has_stored = has_stored_preferred_operators[current_state];
+    vector<OperatorID> &stored = stored_preferred_operators[current_state];
+    if (has_stored.test(0)) {
+        for (OperatorID op_id : stored) {
+            preferred_operators.insert(op_id);
+        }
+    } else {
+        for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
+            collect_preferred_operators(current_eval_context,
+                                        preferred_operator_evaluator.get(),
+                                        preferred_operators);
+        }
+        stored.assign(preferred_operators.begin(), preferred_operators.end());
+        stored.shrink_to_fit();
+        has_stored.set(0);
+    }
+}
+
 void LazySearch::generate_successors() {
     ordered_set::OrderedSet<OperatorID> preferred_operators;
-    for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
-        collect_preferred_operators(current_eval_context,
-                                    preferred_operator_evaluator.get(),
-                                    preferred_operators);
-    }
+    collect_current_preferred_operators(preferred_operators);
     if (randomize_successors) {
         preferred_operators.shuffle(*rng);
     }
@@ -115,34 +232,108 @@ void LazySearch::generate_successors() {
     }
 }
 
-SearchStatus LazySearch::fetch_next_state() {
-    if (open_list->empty()) {
-        log << "Completely explored state space -- no solution!" << endl;
-        return FAILED;
+void LazySearch::evaluate_batch() {
+    /*
+      We only evaluate states that are new and skip duplicates within the
+      batch. The remaining states are evaluated when they are processed
+      (if necessary).
+    */
+    vector<BatchEntry *> entries;
+    // Registered states are identified by the address of their data.
+    set<const PackedStateBin *> states;
+    for (BatchEntry &entry : batch) {
+        if (search_space.get_node(entry.state).is_new() &&
+            states.insert(entry.state.get_buffer()).second) {
+            entries.push_back(&entry);
+        }
     }
 
-    EdgeOpenListEntry next = open_list->remove_min();
+    int num_evaluators = copied_evaluators.size();
+    vector<vector<EvaluationResult>> results(entries.size());
+    utils::parallel_for(num_threads, num_threads, [&](int thread_id) {
+            const vector<shared_ptr<Evaluator>> &copies = evaluator_copies[thread_id];
+            for (size_t i = thread_id; i < entries.size(); i += num_threads) {
+                EvaluationContext eval_context(
+                    entries[i]->state, entries[i]->g, true, nullptr);
+                for (const shared_ptr<Evaluator> &copy : copies) {
+                    results[i].push_back(eval_context.get_result(copy.get()));
+                }
+            }
+        });
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        for (int j = 0; j < num_evaluators; ++j) {
+            Evaluator *evaluator = copied_evaluators[j];
+            const EvaluationResult &result = results[i][j];
+            entries[i]->eval_context.set_result(evaluator, result);
+            if (evaluator->is_used_for_counting_evaluations() &&
+                result.get_count_evaluation()) {
+                statistics.inc_evaluations();
+            }
+        }
+    }
+}
 
-    current_predecessor_id = next.first;
-    current_operator_id = next.second;
-    State current_predecessor = state_registry.lookup_state(current_predecessor_id);
-    OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
-    assert(task_properties::is_applicable(current_operator, current_predecessor));
-    current_state = state_registry.get_successor_state(current_predecessor, current_operator);
+void LazySearch::fill_batch() {
+    assert(batch.empty());
+    for (int i = 0; i < batch_size && !open_list->empty(); ++i) {
+        EdgeOpenListEntry next = open_list->remove_min();
 
-    SearchNode pred_node = search_space.get_node(current_predecessor);
-    current_g = pred_node.get_g() + get_adjusted_cost(current_operator);
-    current_real_g = pred_node.get_real_g() + current_operator.get_cost();
+        StateID predecessor_id = next.first;
+        OperatorID operator_id = next.second;
+        State predecessor = state_registry.lookup_state(predecessor_id);
+        OperatorProxy op = task_proxy.get_operators()[operator_id];
+        assert(task_properties::is_applicable(op, predecessor));
+        /*
+          If the successor was registered before, the state returned by
+          get_successor_state refers to temporary data that is overwritten
+          by the next call, so we look up the registered state.
+        */
+        StateID id = state_registry.get_successor_state(predecessor, op).get_id();
+        State state = state_registry.lookup_state(id);
 
-    /*
-      Note: We mark the node in current_eval_context as "preferred"
-      here. This probably doesn't matter much either way because the
-      node has already been selected for expansion, but eventually we
-      should think more deeply about which path information to
-      associate with the expanded vs. evaluated nodes in lazy search
-      and where to obtain it from.
-    */
-    current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+        SearchNode pred_node = search_space.get_node(predecessor);
+        int g = pred_node.get_g() + get_adjusted_cost(op);
+        int real_g = pred_node.get_real_g() + op.get_cost();
+
+        /*
+          Note: We mark the node in the evaluation context as "preferred"
+          here. This probably doesn't matter much either way because the
+          node has already been selected for expansion, but eventually we
+          should think more deeply about which path information to
+          associate with the expanded vs. evaluated nodes in lazy search
+          and where to obtain it from.
+        */
+        EvaluationContext eval_context(state, g, true, &statistics);
+        batch.push_back({predecessor_id, operator_id, state, g, real_g,
+                         move(eval_context)});
+    }
+    if (num_threads > 1) {
+        evaluate_batch();
+    }
+}
+
+SearchStatus LazySearch::fetch_next_state() {
+    if (batch.empty()) {
+        fill_batch();
+    }
+    if (batch.empty()) {
+        if (found_solution()) {
+            log << "Completely explored state space -- no cheaper plan!" << endl;
+            return SOLVED;
+        }
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+
+    BatchEntry &entry = batch.front();
+    current_predecessor_id = entry.predecessor_id;
+    current_operator_id = entry.operator_id;
+    current_state = entry.state;
+    current_g = entry.g;
+    current_real_g = entry.real_g;
+    current_eval_context = move(entry.eval_context);
+    batch.pop_front();
 
     return IN_PROGRESS;
 }
@@ -189,8 +380,11 @@ SearchStatus LazySearch::step() {
                 }
             }
             node.close();
-            if (check_goal_and_set_plan(current_state))
-                return SOLVED;
+            if (check_goal_and_set_plan(current_state)) {
+                if (restart_open_list_factories.empty())
+                    return SOLVED;
+                return restart();
+            }
             if (search_progress.check_progress(current_eval_context)) {
                 statistics.print_checkpoint_line(current_g);
                 reward_progress();
@@ -208,6 +402,44 @@ SearchStatus LazySearch::step() {
     return fetch_next_state();
 }
 
+void LazySearch::start_from_initial_state() {
+    State initial_state = state_registry.get_initial_state();
+    for (Evaluator *evaluator : path_dependent_evaluators) {
+        evaluator->notify_initial_state(initial_state);
+    }
+    current_state = initial_state;
+    current_predecessor_id = StateID::no_state;
+    current_operator_id = OperatorID::no_operator;
+    current_g = 0;
+    current_real_g = 0;
+    current_eval_context = EvaluationContext(current_state, 0, true, &statistics);
+}
+
+SearchStatus LazySearch::restart() {
+    const Plan &plan = get_plan();
+    int plan_cost = calculate_plan_cost(plan, task_proxy);
+    plan_manager.save_plan(plan, task_proxy, true);
+    bound = plan_cost;
+
+    int num_factories = restart_open_list_factories.size();
+    // No plan is cheaper than a plan of cost 0.
+    if (bound == 0 || (num_restarts == num_factories && !repeat_last_restart)) {
+        return SOLVED;
+    }
+    const shared_ptr<OpenListFactory> &factory =
+        restart_open_list_factories[min(num_restarts, num_factories - 1)];
+    ++num_restarts;
+    log << "Restart " << num_restarts << " with (real) bound = " << bound
+        << endl;
+
+    open_list = factory->create_edge_open_list();
+    batch.clear();
+    search_space.reset();
+    search_progress = SearchProgress();
+    start_from_initial_state();
+    return IN_PROGRESS;
+}
+
 void LazySearch::reward_progress() {
     open_list->boost_preferred();
 }
@@ -215,5 +447,15 @@ void LazySearch::reward_progress() {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    if (!restart_open_list_factories.empty()) {
+        log << "Restarts: " << num_restarts << endl;
+    }
+}
+
+void LazySearch::save_plan_if_necessary() {
+    // With restarts, we save each plan when it is found.
+    if (restart_open_list_factories.empty()) {
+        SearchAlgorithm::save_plan_if_necessary();
+    }
 }
 }
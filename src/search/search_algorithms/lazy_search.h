@@ -5,17 +5,32 @@
 #include "../evaluator.h"
 #include "../open_list.h"
 #include "../operator_id.h"
+#include "../per_state_bitset.h"
+#include "../per_state_information.h"
 #include "../search_algorithm.h"
 #include "../search_progress.h"
 #include "../search_space.h"
 
 #include "../utils/rng.h"
 
+#include <deque>
 #include <memory>
 #include <vector>
 
+class OpenListFactory;
+
 namespace lazy_search {
 class LazySearch : public SearchAlgorithm {
+    // An open list entry that was removed from the open list.
+    struct BatchEntry {
+        StateID predecessor_id;
+        OperatorID operator_id;
+        State state;
+        int g;
+        int real_g;
+        EvaluationContext eval_context;
+    };
+
 protected:
     std::unique_ptr<EdgeOpenList> open_list;
 
@@ -28,6 +43,39 @@ protected:
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
 
+    /*
+      We remove batch_size entries from the open list at once and process
+      them one after the other before removing the next batch. With more
+      than one thread, the states of a batch are evaluated in parallel
+      before processing them. Each thread uses its own copies of the
+      path-independent evaluators in parallel_evaluators (and of the
+      preferred operator evaluators). All other evaluators are evaluated
+      when processing the states.
+    */
+    int batch_size;
+    int num_threads;
+    std::vector<std::shared_ptr<Evaluator>> parallel_evaluators;
+    std::deque<BatchEntry> batch;
+    // Evaluators that we evaluate in parallel and their copies per thread.
+    std::vector<Evaluator *> copied_evaluators;
+    std::vector<std::vector<std::shared_ptr<Evaluator>>> evaluator_copies;
+
+    /*
+      After finding a plan, we can restart the search from the initial state
+      with the next open list of restart_open_list_factories (and then keep
+      restarting with the last one if repeat_last_restart is set). Plans are
+      saved when they are found and their cost becomes the new bound.
+      Restarts keep the state registry and the evaluators, so the values
+      that the evaluators cache for the registered states are reused.
+      Preferred operators are not cached by the evaluators, so we store them
+      for all expanded states.
+    */
+    std::vector<std::shared_ptr<OpenListFactory>> restart_open_list_factories;
+    bool repeat_last_restart;
+    int num_restarts;
+    PerStateInformation<std::vector<OperatorID>> stored_preferred_operators;
+    PerStateBitset has_stored_preferred_operators;
+
     State current_state;
     StateID current_predecessor_id;
     OperatorID current_operator_id;
@@ -38,8 +86,15 @@ protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
 
+    void collect_current_preferred_operators(
+        ordered_set::OrderedSet<OperatorID> &preferred_operators);
     void generate_successors();
+    void create_evaluator_copies();
+    void evaluate_batch();
+    void fill_batch();
     SearchStatus fetch_next_state();
+    void start_from_initial_state();
+    SearchStatus restart();
 
     void reward_progress();
 
@@ -51,8 +106,16 @@ public:
     virtual ~LazySearch() = default;
 
     void set_preferred_operator_evaluators(std::vector<std::shared_ptr<Evaluator>> &evaluators);
+    void set_batch_options(
+        int batch_size, int num_threads,
+        const std::vector<std::shared_ptr<Evaluator>> &parallel_evaluators);
+
+    void set_restart_options(
+        const std::vector<std::shared_ptr<OpenListFactory>> &open_list_factories,
+        bool repeat_last);
 
     virtual void print_statistics() const override;
+    virtual void save_plan_if_necessary() override;
 };
 }
 
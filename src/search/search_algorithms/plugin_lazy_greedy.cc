@@ -30,6 +30,20 @@ public:
             "boost value for alternation queues that are restricted "
             "to preferred operator nodes",
             DEFAULT_LAZY_BOOST);
+        add_option<int>(
+            "batch_size",
+            "number of open list entries that are removed from the open list "
+            "at once. The states of a batch are processed one after the other "
+            "before the next batch is removed, so the successors of a state "
+            "can only be selected in a later batch.",
+            "1",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "threads",
+            "number of threads for evaluating the states of a batch. Each "
+            "thread uses its own copies of the evaluators.",
+            "1",
+            plugins::Bounds("1", "infinity"));
         SearchAlgorithm::add_succ_order_options(*this);
         SearchAlgorithm::add_options_to_feature(*this);
 
@@ -67,6 +81,19 @@ public:
             "is equivalent to\n"
             "```\n--search lazy(single(eval1))\n```\n",
             true);
+        document_note(
+            "Parallel evaluation",
+            "With threads > 1, the states of a batch that have not been "
+            "reached before are evaluated in parallel before they are "
+            "processed. For this, each thread creates its own copies of the "
+            "evaluators in evals and preferred by parsing their "
+            "configurations again, so these configurations must not refer to "
+            "variables (e.g., let(h, ff(), lazy_greedy([h], ...)) is fine, "
+            "but lazy_greedy([sum([h, g()])], ...) with a variable h is not). "
+            "Path-dependent evaluators (like the landmark heuristics) are not "
+            "copied but evaluated in the main thread. The evaluator values "
+            "do not depend on the number of threads, so with a fixed batch "
+            "size and random seed, the search is deterministic.");
     }
 
     virtual shared_ptr<lazy_search::LazySearch> create_component(const plugins::Options &options, const utils::Context &) const override {
@@ -76,6 +103,9 @@ public:
         // TODO: The following two lines look fishy. See similar comment in _parse.
         vector<shared_ptr<Evaluator>> preferred_list = options_copy.get_list<shared_ptr<Evaluator>>("preferred");
         search_algorithm->set_preferred_operator_evaluators(preferred_list);
+        search_algorithm->set_batch_options(
+            options.get<int>("batch_size"), options.get<int>("threads"),
+            options.get_list<shared_ptr<Evaluator>>("evals"));
         return search_algorithm;
     }
 };
@@ -1,6 +1,8 @@
 #include "lazy_search.h"
 #include "search_common.h"
 
+#include "../open_list_factory.h"
+
 #include "../plugins/plugin.h"
 
 using namespace std;
@@ -31,6 +33,16 @@ public:
             "boost value for preferred operator open lists",
             DEFAULT_LAZY_BOOST);
         add_option<int>("w", "evaluator weight", "1");
+        add_list_option<int>(
+            "restart_weights",
+            "weights for restarting the search after it finds a plan "
+            "(see note on restarts)",
+            "[]");
+        add_option<bool>(
+            "repeat_last",
+            "keep restarting with the last of the restart_weights until no "
+            "cheaper plan is found",
+            "false");
         SearchAlgorithm::add_succ_order_options(*this);
         SearchAlgorithm::add_options_to_feature(*this);
 
@@ -44,6 +56,32 @@ public:
             "In the special case with only one evaluator and no preferred "
             "operator evaluators, it uses a single queue that "
             "is ranked by g + w * h. ");
+        document_note(
+            "Restarts",
+            "If restart_weights is not empty, the search is an anytime "
+            "search similar to restarting weighted A* "
+            "(Richter, Thayer and Ruml, ICAPS 2010). Whenever it finds a "
+            "plan, the plan is saved (as sas_plan.1, sas_plan.2, ...), its "
+            "cost becomes the new bound, and the search starts again from "
+            "the initial state with an open list that uses the next weight. "
+            "In contrast to iterated search with one lazy_wastar search per "
+            "weight, all restarts share the state registry and the "
+            "evaluators. Like this, the evaluators are only set up once "
+            "(e.g., the landmark graph) and the heuristic values that they "
+            "cache for states seen before are reused. The search stops when "
+            "it finds a plan with the last weight (unless repeat_last is "
+            "set) or when it completely explores the states below the bound."
+            "\n\n"
+            "```\n--search lazy_wastar([h1, h2], preferred=[h1, h2], w=5,\n"
+            "                     restart_weights=[3, 2, 1], repeat_last=true)\n```\n"
+            "is similar to\n"
+            "```\n--search iterated([lazy_wastar([h1, h2], preferred=[h1, h2], w=5),\n"
+            "                   lazy_wastar([h1, h2], preferred=[h1, h2], w=3),\n"
+            "                   lazy_wastar([h1, h2], preferred=[h1, h2], w=2),\n"
+            "                   lazy_wastar([h1, h2], preferred=[h1, h2], w=1)],\n"
+            "                  repeat_last=true)\n```\n"
+            "(with h1 and h2 defined by let).",
+            true);
         document_note(
             "Equivalent statements using general lazy search",
             "\n```\n--evaluator h1=eval1\n"
@@ -85,6 +123,16 @@ public:
         // TODO: The following two lines look fishy. See similar comment in _parse.
         vector<shared_ptr<Evaluator>> preferred_list = options_copy.get_list<shared_ptr<Evaluator>>("preferred");
         search_algorithm->set_preferred_operator_evaluators(preferred_list);
+
+        vector<shared_ptr<OpenListFactory>> restart_open_list_factories;
+        for (int weight : options.get_list<int>("restart_weights")) {
+            plugins::Options restart_options(options);
+            restart_options.set("w", weight);
+            restart_open_list_factories.push_back(
+                search_common::create_wastar_open_list_factory(restart_options));
+        }
+        search_algorithm->set_restart_options(
+            restart_open_list_factories, options.get<bool>("repeat_last"));
         return search_algorithm;
     }
 };
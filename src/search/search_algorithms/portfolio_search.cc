@@ -0,0 +1,161 @@
+#include "portfolio_search.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/logging.h"
+#include "../utils/parallel.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace portfolio_search {
+PortfolioSearch::PortfolioSearch(const plugins::Options &opts)
+    : SearchAlgorithm(opts),
+      algorithm_configs(opts.get_list<parser::LazyValue>("algorithm_configs")),
+      optimal(opts.get<bool>("optimal")) {
+}
+
+shared_ptr<SearchAlgorithm> PortfolioSearch::create_search_algorithm(int index) {
+    parser::LazyValue &algorithm_config = algorithm_configs[index];
+    shared_ptr<SearchAlgorithm> search_algorithm;
+    try {
+        search_algorithm = algorithm_config.construct<shared_ptr<SearchAlgorithm>>();
+    } catch (const utils::ContextError &e) {
+        cerr << "Delayed construction of LazyValue failed" << endl;
+        cerr << e.get_message() << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    log << "Created search " << index << ": "
+        << search_algorithm->get_description() << endl;
+    return search_algorithm;
+}
+
+void PortfolioSearch::run_search_algorithm(int index) {
+    SearchAlgorithm &algorithm = *algorithms[index];
+    algorithm.search();
+
+    lock_guard<mutex> lock(result_mutex);
+    if (algorithm.found_solution()) {
+        const Plan &found_plan = algorithm.get_plan();
+        int plan_cost = calculate_plan_cost(found_plan, task_proxy);
+        if (plan_cost < bound) {
+            log << "Search " << index << " found a plan with cost "
+                << plan_cost << "." << endl;
+            plan_manager.save_plan(found_plan, task_proxy, true);
+            bound = plan_cost;
+            set_plan(found_plan);
+            for (const shared_ptr<SearchAlgorithm> &other : algorithms) {
+                other->set_bound(plan_cost);
+            }
+        }
+    }
+    /*
+      If an optimal search algorithm terminates without a timeout, no plan
+      is cheaper than the best plan found so far (if any).
+    */
+    SearchStatus status = algorithm.get_status();
+    if (optimal && (status == SOLVED || status == FAILED)) {
+        log << "Search " << index << " proved optimality. Stop all searches."
+            << endl;
+        for (const shared_ptr<SearchAlgorithm> &other : algorithms) {
+            other->request_stop();
+        }
+    }
+}
+
+SearchStatus PortfolioSearch::step() {
+    int num_algorithms = algorithm_configs.size();
+    for (int i = 0; i < num_algorithms; ++i) {
+        algorithms.push_back(create_search_algorithm(i));
+        algorithms.back()->set_bound(bound);
+    }
+
+    log << "Running " << num_algorithms << " searches in parallel." << endl;
+    utils::parallel_for(num_algorithms, num_algorithms, [this](int i) {
+            run_search_algorithm(i);
+        });
+
+    for (int i = 0; i < num_algorithms; ++i) {
+        const SearchAlgorithm &algorithm = *algorithms[i];
+        log << "Statistics of search " << i << ":" << endl;
+        algorithm.print_statistics();
+
+        const SearchStatistics &stats = algorithm.get_statistics();
+        statistics.inc_expanded(stats.get_expanded());
+        statistics.inc_evaluated_states(stats.get_evaluated_states());
+        statistics.inc_evaluations(stats.get_evaluations());
+        statistics.inc_generated(stats.get_generated());
+        statistics.inc_generated_ops(stats.get_generated_ops());
+        statistics.inc_reopened(stats.get_reopened());
+    }
+    algorithms.clear();
+
+    if (found_solution()) {
+        log << "Best solution cost: " << bound << endl;
+        return SOLVED;
+    }
+    return FAILED;
+}
+
+void PortfolioSearch::print_statistics() const {
+    log << "Cumulative statistics:" << endl;
+    statistics.print_detailed_statistics();
+}
+
+void PortfolioSearch::save_plan_if_necessary() {
+    // We don't need to save here, as we save each plan when it is found.
+}
+
+class PortfolioSearchFeature : public plugins::TypedFeature<SearchAlgorithm, PortfolioSearch> {
+public:
+    PortfolioSearchFeature() : TypedFeature("portfolio") {
+        document_title("Portfolio search");
+        document_synopsis(
+            "Runs the given search algorithms concurrently, each in its own "
+            "thread. The algorithms share the task and the data computed for "
+            "it, like the successor generator. Each plan that is cheaper than "
+            "all plans found before is saved (as sas_plan.1, sas_plan.2, ...) "
+            "and its cost becomes the bound of all algorithms that are still "
+            "running. The portfolio stops when all algorithms have stopped.");
+
+        add_list_option<shared_ptr<SearchAlgorithm>>(
+            "algorithm_configs",
+            "list of search algorithms to run in parallel",
+            "",
+            true);
+        add_option<bool>(
+            "optimal",
+            "all search algorithms are optimal, i.e., a plan they find is "
+            "optimal among the plans below their bound, and if they "
+            "terminate without a plan, there is no plan below their bound. "
+            "Then we stop all algorithms as soon as one of them terminates "
+            "without a timeout.",
+            "false");
+        SearchAlgorithm::add_options_to_feature(*this);
+
+        document_note(
+            "Shared evaluators",
+            "Evaluators are not thread-safe, so the algorithms must not "
+            "share evaluators, e.g., through variables defined with let. "
+            "Each algorithm configuration should create its own evaluators.");
+        document_note(
+            "Search algorithms",
+            "The algorithms should not save plans themselves, so iterated "
+            "search cannot be used inside a portfolio. The time limits of the "
+            "algorithms (max_time) are measured in CPU time of the whole "
+            "planner, i.e., including the time of all threads.");
+    }
+
+    virtual shared_ptr<PortfolioSearch> create_component(const plugins::Options &options, const utils::Context &context) const override {
+        plugins::Options options_copy(options);
+        // See IteratedSearchFeature for why we unpack the list here.
+        vector<parser::LazyValue> algorithm_configs =
+            options.get<parser::LazyValue>("algorithm_configs").construct_lazy_list();
+        options_copy.set("algorithm_configs", algorithm_configs);
+        plugins::verify_list_non_empty<parser::LazyValue>(context, options_copy, "algorithm_configs");
+        return make_shared<PortfolioSearch>(options_copy);
+    }
+};
+
+static plugins::FeaturePlugin<PortfolioSearchFeature> _plugin;
+}
@@ -0,0 +1,41 @@
+#ifndef SEARCH_ALGORITHMS_PORTFOLIO_SEARCH_H
+#define SEARCH_ALGORITHMS_PORTFOLIO_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace portfolio_search {
+/*
+  Run several search algorithms concurrently, each in its own thread. The
+  algorithms are constructed one after the other in the main thread, so they
+  share the task and the data computed for it (successor generator, state
+  packer, axiom evaluator). Whenever an algorithm finds a plan that is
+  cheaper than all plans found before, we save it and lower the bound of
+  all algorithms to its cost.
+*/
+class PortfolioSearch : public SearchAlgorithm {
+    std::vector<parser::LazyValue> algorithm_configs;
+    bool optimal;
+
+    std::vector<std::shared_ptr<SearchAlgorithm>> algorithms;
+    std::mutex result_mutex;
+
+    std::shared_ptr<SearchAlgorithm> create_search_algorithm(int index);
+    void run_search_algorithm(int index);
+
+    virtual SearchStatus step() override;
+
+public:
+    explicit PortfolioSearch(const plugins::Options &opts);
+
+    virtual void save_plan_if_necessary() override;
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
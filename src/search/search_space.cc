@@ -162,6 +162,12 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
     }
 }
 
+void SearchSpace::reset() {
+    for (StateID id : state_registry) {
+        search_node_infos[state_registry.lookup_state(id)] = SearchNodeInfo();
+    }
+}
+
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics(log);
 }
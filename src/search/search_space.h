@@ -57,6 +57,8 @@ public:
     SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
 
     SearchNode get_node(const State &state);
+    // Mark all nodes as new, e.g., to restart the search from scratch.
+    void reset();
     void trace_path(const State &goal_state,
                     std::vector<OperatorID> &path) const;
 
@@ -11,6 +11,7 @@
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include <memory_resource>
 #include <set>
 
 /*
@@ -58,6 +59,9 @@
     This class is used to store the actual (packed) state data for all states
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
+    The segments are allocated from the memory resource of the registry
+    (see StateStorage), which is also used for the information associated
+    with its states.
 
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
@@ -111,13 +115,24 @@ class IntPacker;
 
 using PackedStateBin = int_packer::IntPacker::Bin;
 
+/*
+  Segmented vectors for data associated with the states of a registry. They
+  allocate their segments from the memory resource of the registry.
+*/
+template<class Entry>
+using StateDataVector = segmented_vector::SegmentedVector<
+    Entry, std::pmr::polymorphic_allocator<Entry>>;
+template<class Element>
+using StateDataArrayVector = segmented_vector::SegmentedArrayVector<
+    Element, std::pmr::polymorphic_allocator<Element>>;
+
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataArrayVector<PackedStateBin> &state_data_pool;
         int state_size;
         StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataArrayVector<PackedStateBin> &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
@@ -134,10 +149,10 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataArrayVector<PackedStateBin> &state_data_pool;
         int state_size;
         StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataArrayVector<PackedStateBin> &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
@@ -161,8 +176,9 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
+    std::pmr::memory_resource *memory_resource;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    StateDataArrayVector<PackedStateBin> state_data_pool;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
@@ -170,7 +186,9 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     StateID insert_id_or_pop_state();
     int get_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    explicit StateRegistry(
+        const TaskProxy &task_proxy,
+        std::pmr::memory_resource *memory_resource = std::pmr::get_default_resource());
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -203,6 +221,13 @@ public:
     */
     State get_successor_state(const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Returns the state with the given packed data (as returned by
+      State::get_buffer of a state of any registry for the same task) and
+      registers it if this was not done before.
+    */
+    State insert_packed_state(const PackedStateBin *buffer);
+
     /*
       Returns the number of states registered so far.
     */
@@ -212,6 +237,10 @@ public:
 
     int get_state_size_in_bytes() const;
 
+    std::pmr::memory_resource *get_memory_resource() const {
+        return memory_resource;
+    }
+
     void print_statistics(utils::LogProxy &log) const;
 
     class const_iterator {
@@ -0,0 +1,98 @@
+#include "state_storage.h"
+
+#include "plugins/plugin.h"
+#include "utils/logging.h"
+#include "utils/memory_mapped_file.h"
+
+using namespace std;
+
+void StateStorage::print_statistics(utils::LogProxy &) const {
+}
+
+pmr::memory_resource *RAMStateStorage::get_memory_resource() {
+    return pmr::get_default_resource();
+}
+
+MappedFileStateStorage::MappedFileStateStorage(const plugins::Options &opts)
+    : memory_resource(utils::make_unique_ptr<utils::MappedFileMemoryResource>(
+                          opts.get<string>("directory"),
+                          static_cast<size_t>(opts.get<int>("ram_budget")) * 1024 * 1024)) {
+}
+
+MappedFileStateStorage::~MappedFileStateStorage() {
+}
+
+pmr::memory_resource *MappedFileStateStorage::get_memory_resource() {
+    return memory_resource.get();
+}
+
+void MappedFileStateStorage::print_statistics(utils::LogProxy &log) const {
+    if (log.is_at_least_normal()) {
+        log << "State storage file size: "
+            << memory_resource->get_file_size() / 1024 << " KB" << endl
+            << "State storage released from RAM: "
+            << memory_resource->get_released_size() / 1024 << " KB" << endl;
+    }
+}
+
+class RAMStateStorageFeature
+    : public plugins::TypedFeature<StateStorage, RAMStateStorage> {
+public:
+    RAMStateStorageFeature() : TypedFeature("ram") {
+        document_title("RAM state storage");
+        document_synopsis("Store all states in main memory.");
+    }
+
+    virtual shared_ptr<RAMStateStorage> create_component(
+        const plugins::Options &, const utils::Context &) const override {
+        return make_shared<RAMStateStorage>();
+    }
+};
+
+static plugins::FeaturePlugin<RAMStateStorageFeature> _plugin_ram;
+
+class MappedFileStateStorageFeature
+    : public plugins::TypedFeature<StateStorage, MappedFileStateStorage> {
+public:
+    MappedFileStateStorageFeature() : TypedFeature("mmap") {
+        document_title("Memory-mapped file state storage");
+        document_synopsis(
+            "Store states in a temporary file that is mapped into memory. "
+            "Only the most recently allocated part of the file is kept in "
+            "RAM. Older parts are written to disk and loaded again by the "
+            "operating system when they are accessed. Duplicate detection "
+            "only keeps state IDs and 32-bit hash values in RAM and only "
+            "accesses the stored states when the hash values match.");
+        add_option<string>(
+            "directory",
+            "directory for the temporary file. Preferably, it should be on a "
+            "fast local disk.",
+            "\".\"");
+        add_option<int>(
+            "ram_budget",
+            "number of MiB of the file that are kept in RAM",
+            "1024",
+            plugins::Bounds("1", "infinity"));
+        document_note(
+            "Memory limits",
+            "The mapped file counts towards the address space of the planner. "
+            "If you limit the memory of the planner by limiting its address "
+            "space (e.g., with the memory limits of the driver script), the "
+            "limit has to include the size of the file.");
+        document_note(
+            "Supported operating systems",
+            "This state storage is only supported on Linux and macOS.");
+    }
+};
+
+static plugins::FeaturePlugin<MappedFileStateStorageFeature> _plugin_mmap;
+
+static class StateStorageCategoryPlugin
+    : public plugins::TypedCategoryPlugin<StateStorage> {
+public:
+    StateStorageCategoryPlugin() : TypedCategoryPlugin("StateStorage") {
+        document_synopsis(
+            "Determines where the states of a search are stored.");
+    }
+}
+_category_plugin;
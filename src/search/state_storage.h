@@ -0,0 +1,44 @@
+#ifndef STATE_STORAGE_H
+#define STATE_STORAGE_H
+
+#include <memory>
+#include <memory_resource>
+
+namespace plugins {
+class Options;
+}
+
+namespace utils {
+class LogProxy;
+class MappedFileMemoryResource;
+}
+
+/*
+  A state storage provides the memory for the packed states of a
+  StateRegistry and for the information associated with its states (see
+  PerStateInformation and PerStateArray).
+*/
+class StateStorage {
+public:
+    virtual ~StateStorage() = default;
+
+    virtual std::pmr::memory_resource *get_memory_resource() = 0;
+    virtual void print_statistics(utils::LogProxy &log) const;
+};
+
+class RAMStateStorage : public StateStorage {
+public:
+    virtual std::pmr::memory_resource *get_memory_resource() override;
+};
+
+class MappedFileStateStorage : public StateStorage {
+    std::unique_ptr<utils::MappedFileMemoryResource> memory_resource;
+public:
+    explicit MappedFileStateStorage(const plugins::Options &opts);
+    virtual ~MappedFileStateStorage() override;
+
+    virtual std::pmr::memory_resource *get_memory_resource() override;
+    virtual void print_statistics(utils::LogProxy &log) const override;
+};
+
+#endif
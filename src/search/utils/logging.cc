@@ -7,6 +7,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 using namespace std;
@@ -22,6 +23,30 @@ static shared_ptr<Log> global_log = make_shared<Log>(Verbosity::NORMAL);
 
 LogProxy g_log(global_log);
 
+// Protects the output streams of all logs.
+static mutex output_mutex;
+
+Log::LineBuffer &Log::get_line_buffer() {
+    thread_local LineBuffer buffer;
+    return buffer;
+}
+
+void Log::write_line_buffer(LineBuffer &buffer, bool end_line) {
+    {
+        lock_guard<mutex> lock(output_mutex);
+        stream << buffer.text.str();
+        if (end_line) {
+            stream << endl;
+        } else {
+            stream << flush;
+        }
+    }
+    buffer.text.str("");
+    if (end_line) {
+        buffer.line_has_started = false;
+    }
+}
+
 void add_log_options_to_feature(plugins::Feature &feature) {
     feature.add_option<Verbosity>(
         "verbosity",
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -29,37 +30,52 @@ enum class Verbosity {
   of output. Lines should be eventually terminated by endl. Logs are written to
   stdout.
 
+  Each thread collects the current line in its own buffer and writes it to
+  the stream as a whole when the line ends (or is flushed), so lines logged
+  by concurrent threads don't interleave.
+
   Internal class encapsulated by LogProxy.
 */
 class Log {
+    struct LineBuffer {
+        std::ostringstream text;
+        bool line_has_started = false;
+    };
+
     std::ostream &stream;
     const Verbosity verbosity;
-    bool line_has_started;
+
+    static LineBuffer &get_line_buffer();
+    void write_line_buffer(LineBuffer &buffer, bool end_line);
 
 public:
     explicit Log(Verbosity verbosity)
-        : stream(std::cout), verbosity(verbosity), line_has_started(false) {
+        : stream(std::cout), verbosity(verbosity) {
     }
 
     template<typename T>
     Log &operator<<(const T &elem) {
-        if (!line_has_started) {
-            line_has_started = true;
-            stream << "[t=" << g_timer << ", "
-                   << get_peak_memory_in_kb() << " KB] ";
+        LineBuffer &buffer = get_line_buffer();
+        if (!buffer.line_has_started) {
+            buffer.line_has_started = true;
+            buffer.text << "[t=" << g_timer << ", "
+                        << get_peak_memory_in_kb() << " KB] ";
         }
 
-        stream << elem;
+        buffer.text << elem;
         return *this;
     }
 
     using manip_function = std::ostream &(*)(std::ostream &);
     Log &operator<<(manip_function f) {
+        LineBuffer &buffer = get_line_buffer();
         if (f == static_cast<manip_function>(&std::endl)) {
-            line_has_started = false;
+            write_line_buffer(buffer, true);
+        } else if (f == static_cast<manip_function>(&std::flush)) {
+            write_line_buffer(buffer, false);
+        } else {
+            buffer.text << f;
         }
-
-        stream << f;
         return *this;
     }
 
@@ -2,20 +2,31 @@
 
 #include "../utils/logging.h"
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 
 using namespace std;
 
 namespace utils {
-static char *extra_memory_padding = nullptr;
+/*
+  The padding is atomic since threads that run out of memory concurrently
+  may all call the out-of-memory handler, but only one of them may free
+  the padding.
+*/
+static atomic<char *> extra_memory_padding(nullptr);
 
 // Save standard out-of-memory handler.
 static void (*standard_out_of_memory_handler)() = nullptr;
 
 void continuing_out_of_memory_handler() {
-    release_extra_memory_padding();
-    utils::g_log << "Failed to allocate memory. Released extra memory padding." << endl;
+    char *padding = extra_memory_padding.exchange(nullptr);
+    if (padding) {
+        delete[] padding;
+        assert(standard_out_of_memory_handler);
+        set_new_handler(standard_out_of_memory_handler);
+        utils::g_log << "Failed to allocate memory. Released extra memory padding." << endl;
+    }
 }
 
 void reserve_extra_memory_padding(int memory_in_mb) {
@@ -25,14 +36,14 @@ void reserve_extra_memory_padding(int memory_in_mb) {
 }
 
 void release_extra_memory_padding() {
-    assert(extra_memory_padding);
-    delete[] extra_memory_padding;
-    extra_memory_padding = nullptr;
+    char *padding = extra_memory_padding.exchange(nullptr);
+    assert(padding);
+    delete[] padding;
     assert(standard_out_of_memory_handler);
     set_new_handler(standard_out_of_memory_handler);
 }
 
 bool extra_memory_padding_is_reserved() {
-    return extra_memory_padding;
+    return extra_memory_padding.load() != nullptr;
 }
 }
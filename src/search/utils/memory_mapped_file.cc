@@ -0,0 +1,179 @@
+#include "memory_mapped_file.h"
+
+#include "system.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+static void exit_with_read_error(const string &filename) {
+    cerr << "Failed to read file: " << filename << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MemoryMappedFile::MemoryMappedFile(const string &filename)
+    : data(nullptr),
+      size(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        exit_with_read_error(filename);
+    }
+    struct stat file_status;
+    if (fstat(fd, &file_status) == -1) {
+        close(fd);
+        exit_with_read_error(filename);
+    }
+    size = file_status.st_size;
+    if (size > 0) {
+        void *address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            close(fd);
+            exit_with_read_error(filename);
+        }
+        data = static_cast<const char *>(address);
+    }
+    // The mapping stays valid after closing the file.
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    if (data) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+// Size of the blocks that we map into memory (unless an allocation is larger).
+static const size_t BLOCK_SIZE = 64 * 1024 * 1024;
+
+MappedFileMemoryResource::MappedFileMemoryResource(
+    const string &directory, size_t ram_budget)
+    : fd(-1),
+      ram_budget(ram_budget),
+      file_size(0),
+      used_in_last_block(0),
+      num_released_blocks(0),
+      released_size(0) {
+    string filename = directory + "/downward-state-storage-XXXXXX";
+    vector<char> filename_buffer(filename.begin(), filename.end());
+    filename_buffer.push_back('\0');
+    fd = mkstemp(filename_buffer.data());
+    if (fd == -1) {
+        cerr << "Failed to create state storage file in directory: "
+             << directory << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // The file is deleted once we close it.
+    unlink(filename_buffer.data());
+}
+
+MappedFileMemoryResource::~MappedFileMemoryResource() {
+    for (const Block &block : blocks) {
+        munmap(block.data, block.size);
+    }
+    close(fd);
+}
+
+void MappedFileMemoryResource::add_block(size_t min_size) {
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t size = max(BLOCK_SIZE, (min_size + page_size - 1) / page_size * page_size);
+    if (ftruncate(fd, file_size + size) == -1) {
+        cerr << "Failed to extend the state storage file." << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *address = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, file_size);
+    if (address == MAP_FAILED) {
+        cerr << "Failed to map the state storage file into memory." << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    blocks.push_back({static_cast<char *>(address), size});
+    file_size += size;
+    used_in_last_block = 0;
+    release_old_blocks();
+}
+
+void MappedFileMemoryResource::release_old_blocks() {
+    // The last block always stays in memory.
+    while (num_released_blocks + 1 < blocks.size() &&
+           file_size - released_size > ram_budget) {
+        const Block &block = blocks[num_released_blocks];
+        msync(block.data, block.size, MS_SYNC);
+        madvise(block.data, block.size, MADV_DONTNEED);
+#if OPERATING_SYSTEM == LINUX
+        posix_fadvise(fd, released_size, block.size, POSIX_FADV_DONTNEED);
+#endif
+        released_size += block.size;
+        ++num_released_blocks;
+    }
+}
+
+void *MappedFileMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    size_t offset = (used_in_last_block + alignment - 1) / alignment * alignment;
+    if (blocks.empty() || offset + bytes > blocks.back().size) {
+        add_block(bytes);
+        offset = 0;
+    }
+    used_in_last_block = offset + bytes;
+    return blocks.back().data + offset;
+}
+#else
+MemoryMappedFile::MemoryMappedFile(const string &filename)
+    : data(nullptr),
+      size(0) {
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file) {
+        exit_with_read_error(filename);
+    }
+    buffer.resize(file.tellg());
+    file.seekg(0);
+    if (!file.read(buffer.data(), buffer.size())) {
+        exit_with_read_error(filename);
+    }
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+}
+
+MappedFileMemoryResource::MappedFileMemoryResource(const string &, size_t)
+    : fd(-1),
+      ram_budget(0),
+      file_size(0),
+      used_in_last_block(0),
+      num_released_blocks(0),
+      released_size(0) {
+    cerr << "Storing states in memory-mapped files is not supported on "
+         << "this operating system." << endl;
+    utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+MappedFileMemoryResource::~MappedFileMemoryResource() {
+}
+
+void *MappedFileMemoryResource::do_allocate(size_t, size_t) {
+    ABORT("MappedFileMemoryResource is not supported on this operating system.");
+}
+#endif
+
+void MappedFileMemoryResource::do_deallocate(void *, size_t, size_t) {
+    // Memory is only freed when the resource is destroyed.
+}
+
+bool MappedFileMemoryResource::do_is_equal(
+    const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+}
@@ -0,0 +1,95 @@
+#ifndef UTILS_MEMORY_MAPPED_FILE_H
+#define UTILS_MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Read-only view of the contents of a file. On Linux and macOS, the file
+  is mapped into memory, so its pages are only loaded on demand and are
+  shared between all processes that map the same file. On other systems,
+  we read the whole file into memory.
+
+  Exit with SEARCH_INPUT_ERROR if the file cannot be read.
+*/
+class MemoryMappedFile {
+    const char *data;
+    std::size_t size;
+    // Holds the contents if the file could not be mapped into memory.
+    std::vector<char> buffer;
+public:
+    explicit MemoryMappedFile(const std::string &filename);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+    const char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+
+/*
+  Memory resource that allocates memory from a temporary file in the given
+  directory, which is mapped into memory in blocks. The file is deleted
+  when it is closed, i.e., at the latest when the planner exits.
+
+  Memory is only freed when the resource is destroyed. Whenever the
+  mapped blocks exceed the RAM budget, we write the oldest blocks to disk
+  and release their pages, so that only the most recently allocated
+  blocks stay in RAM. The operating system loads released pages again
+  when they are accessed and can evict them under memory pressure since
+  they are backed by the file instead of swap space.
+
+  This is only supported on Linux and macOS. On other systems, the
+  constructor exits with SEARCH_UNSUPPORTED.
+*/
+class MappedFileMemoryResource : public std::pmr::memory_resource {
+    struct Block {
+        char *data;
+        std::size_t size;
+    };
+
+    int fd;
+    const std::size_t ram_budget;
+    std::vector<Block> blocks;
+    std::size_t file_size;
+    // Number of bytes allocated from the last block.
+    std::size_t used_in_last_block;
+    // Blocks with lower indices are released from memory.
+    std::size_t num_released_blocks;
+    std::size_t released_size;
+
+    void add_block(std::size_t min_size);
+    void release_old_blocks();
+
+    virtual void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    virtual void do_deallocate(
+        void *pointer, std::size_t bytes, std::size_t alignment) override;
+    virtual bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override;
+public:
+    MappedFileMemoryResource(const std::string &directory, std::size_t ram_budget);
+    virtual ~MappedFileMemoryResource() override;
+
+    MappedFileMemoryResource(const MappedFileMemoryResource &) = delete;
+    MappedFileMemoryResource &operator=(const MappedFileMemoryResource &) = delete;
+
+    std::size_t get_file_size() const {
+        return file_size;
+    }
+
+    std::size_t get_released_size() const {
+        return released_size;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,39 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void parallel_for(
+    int num_threads, int num_jobs, const function<void(int)> &job) {
+    assert(num_threads >= 1);
+    if (num_threads == 1 || num_jobs <= 1) {
+        for (int i = 0; i < num_jobs; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    atomic<int> next_job(0);
+    auto run_jobs = [&]() {
+        for (int i = next_job++; i < num_jobs; i = next_job++) {
+            job(i);
+        }
+    };
+    int num_helpers = min(num_threads, num_jobs) - 1;
+    vector<thread> helpers;
+    helpers.reserve(num_helpers);
+    for (int i = 0; i < num_helpers; ++i) {
+        helpers.emplace_back(run_jobs);
+    }
+    run_jobs();
+    for (thread &helper : helpers) {
+        helper.join();
+    }
+}
+}
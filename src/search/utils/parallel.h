@@ -0,0 +1,68 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace utils {
+/*
+  Call job(i) for all i in [0, num_jobs) using up to num_threads threads,
+  including the calling thread. Jobs are handed out in increasing order
+  of i to the next idle thread. For num_threads == 1 all jobs run in
+  order in the calling thread and no threads are started.
+
+  The caller is responsible for making job(i) safe to run concurrently
+  with job(j) for i != j. Apart from the logs, most of the planner
+  (e.g., the task transformations with lazily computed data) is not
+  thread-safe, so jobs should only read shared data and write to
+  disjoint locations.
+*/
+extern void parallel_for(
+    int num_threads, int num_jobs, const std::function<void(int)> &job);
+
+/*
+  Sort the vector with up to num_threads threads. Equal elements may end
+  up in any order, so the result only equals the one of std::sort if the
+  order is total.
+*/
+template<typename T, typename Compare = std::less<T>>
+void parallel_sort(
+    int num_threads, std::vector<T> &vec, Compare comp = Compare()) {
+    const int min_range_size = 1 << 12;
+    int num_ranges = std::max(1, std::min(
+        num_threads, static_cast<int>(vec.size() / min_range_size)));
+    if (num_ranges == 1) {
+        std::sort(vec.begin(), vec.end(), comp);
+        return;
+    }
+    std::vector<std::size_t> bounds;
+    for (int i = 0; i <= num_ranges; ++i) {
+        bounds.push_back(vec.size() * i / num_ranges);
+    }
+    parallel_for(num_threads, num_ranges, [&](int i) {
+            std::sort(vec.begin() + bounds[i], vec.begin() + bounds[i + 1], comp);
+        });
+    // Merge neighbouring ranges pairwise until a single range is left.
+    while (bounds.size() > 2) {
+        int num_merges = (bounds.size() - 1) / 2;
+        parallel_for(num_threads, num_merges, [&](int i) {
+                std::inplace_merge(
+                    vec.begin() + bounds[2 * i],
+                    vec.begin() + bounds[2 * i + 1],
+                    vec.begin() + bounds[2 * i + 2],
+                    comp);
+            });
+        std::vector<std::size_t> merged_bounds;
+        for (std::size_t i = 0; i < bounds.size(); i += 2) {
+            merged_bounds.push_back(bounds[i]);
+        }
+        if (merged_bounds.back() != bounds.back()) {
+            merged_bounds.push_back(bounds.back());
+        }
+        bounds.swap(merged_bounds);
+    }
+}
+}
+
+#endif